@@ -0,0 +1,60 @@
+/**
+ * Boot screen baker (host build only)
+ *
+ * Renders the screen the game starts on -- cleared, with the chrome around
+ * the grid -- using the same drawing code as the device, run-length codes
+ * the frame buffer (rle.h) and writes it out as a C header. The firmware
+ * decodes it straight into the frame buffer at the start of a game instead
+ * of clearing the screen and drawing the chrome pixel by pixel.
+ *
+ * boot_screen.h is checked in; run this again after changing anything in
+ * chrome.c or the drawing code it uses:
+ *   cmake -S . -B build-host -DPICO_PLATFORM=host && cmake --build build-host
+ *   build-host/bake_screen boot_screen.h
+ *
+ * Usage: bake_screen [out.h]   (default: stdout)
+ */
+
+#include "chrome.h"
+#include "rle.h"
+#include "vga16_graphics.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SCREEN_BYTES (VGA_STRIDE * VGA_HEIGHT)
+
+static uint8_t encoded[RLE_BOUND(SCREEN_BYTES)];
+
+int main(int argc, char **argv) {
+  FILE *out = stdout;
+  if (argc > 1 && !(out = fopen(argv[1], "w"))) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  memset(vga_data_array, BLACK * 0x11, SCREEN_BYTES);
+  chrome_init();
+  chrome_draw();
+
+  int size = rle_encode(vga_data_array, SCREEN_BYTES, encoded, sizeof(encoded));
+  if (size < 0) {
+    fprintf(stderr, "bake_screen: encoding failed\n");
+    return 1;
+  }
+
+  fprintf(out, "// Generated by bake_screen.c -- do not edit, run it again\n");
+  fprintf(out, "// The starting screen, %d bytes run-length coded from %d\n",
+          size, SCREEN_BYTES);
+  fprintf(out, "#include \"pico/stdlib.h\"\n\n");
+  fprintf(out, "#ifndef BOOT_SCREEN_H\n#define BOOT_SCREEN_H\n\n");
+  fprintf(out, "static const uint8_t boot_screen_rle[%d] = {", size);
+  for (int i = 0; i < size; i++) {
+    fprintf(out, "%s0x%02x,", i % 12 ? " " : "\n    ", encoded[i]);
+  }
+  fprintf(out, "\n};\n\n#endif // BOOT_SCREEN_H\n");
+  if (out != stdout) {
+    fclose(out);
+  }
+  fprintf(stderr, "bake_screen: %d -> %d bytes\n", SCREEN_BYTES, size);
+  return 0;
+}
@@ -0,0 +1,232 @@
+// Generated by bake_screen.c -- do not edit, run it again
+// The starting screen, 2646 bytes run-length coded from 153600
+#include "pico/stdlib.h"
+
+#ifndef BOOT_SCREEN_H
+#define BOOT_SCREEN_H
+
+static const uint8_t boot_screen_rle[2646] = {
+    0xff, 0x61, 0x13, 0x00, 0x00, 0xf0, 0x84, 0xff, 0xff, 0xb3, 0x00, 0x00,
+    0x00, 0xf0, 0x81, 0xff, 0x00, 0x0f, 0x80, 0x00, 0x82, 0xff, 0xff, 0xaf,
+    0x00, 0x00, 0x04, 0xff, 0x0f, 0xff, 0x0f, 0xff, 0x83, 0x00, 0x05, 0xf0,
+    0x0f, 0xff, 0x0f, 0xff, 0x0f, 0xff, 0xab, 0x00, 0x00, 0x05, 0xf0, 0xff,
+    0x00, 0xff, 0x00, 0xf0, 0x85, 0x00, 0x05, 0xf0, 0x00, 0xf0, 0x0f, 0xf0,
+    0xff, 0xff, 0xa9, 0x00, 0x00, 0x06, 0xff, 0x0f, 0x00, 0xff, 0x00, 0x00,
+    0x0f, 0x86, 0x00, 0x06, 0x0f, 0x00, 0xf0, 0x0f, 0x00, 0xff, 0x0f, 0x94,
+    0x00, 0xff, 0x8e, 0x00, 0x77, 0x97, 0xff, 0x01, 0x77, 0x77, 0x91, 0x00,
+    0x00, 0x07, 0xff, 0x8d, 0x00, 0x00, 0x07, 0xf0, 0x00, 0x00, 0xf0, 0x0f,
+    0x00, 0x00, 0x0f, 0x88, 0x00, 0x08, 0x0f, 0x00, 0x00, 0xff, 0x00, 0x00,
+    0xf0, 0x00, 0x70, 0x91, 0x00, 0x00, 0x07, 0xff, 0x8c, 0x00, 0x00, 0x07,
+    0xf0, 0x0f, 0x00, 0x00, 0x0f, 0x00, 0x00, 0xf0, 0x89, 0x00, 0x00, 0xf0,
+    0x80, 0x00, 0x04, 0x0f, 0x00, 0x00, 0xff, 0x70, 0x91, 0x00, 0x00, 0x07,
+    0xff, 0x8c, 0x00, 0x00, 0x03, 0x0f, 0x00, 0x00, 0xf0, 0x80, 0x00, 0x00,
+    0x0f, 0x8a, 0x00, 0x03, 0x0f, 0x00, 0x00, 0xf0, 0x80, 0x00, 0x00, 0x7f,
+    0x91, 0x00, 0x00, 0x07, 0xff, 0x8b, 0x00, 0x00, 0x00, 0xf0, 0x80, 0x00,
+    0x00, 0x0f, 0x80, 0x00, 0x00, 0x0f, 0x8a, 0x00, 0x00, 0x0f, 0x80, 0x00,
+    0x03, 0x0f, 0x00, 0x00, 0xf0, 0x91, 0x00, 0x00, 0x07, 0xff, 0x8b, 0x00,
+    0x00, 0x03, 0x0f, 0x00, 0x00, 0xf0, 0x80, 0x00, 0x00, 0xf0, 0x8b, 0x00,
+    0x00, 0xf0, 0x80, 0x00, 0x04, 0xf0, 0x00, 0x00, 0x70, 0x0f, 0x90, 0x00,
+    0x00, 0x07, 0xff, 0x8a, 0x00, 0x00, 0x00, 0xf0, 0x80, 0x00, 0x00, 0xf0,
+    0x80, 0x00, 0x00, 0xf0, 0x8b, 0x00, 0x00, 0xf0, 0x80, 0x00, 0x04, 0xf0,
+    0x00, 0x00, 0x70, 0xf0, 0x90, 0x00, 0x00, 0x07, 0xff, 0x8a, 0x00, 0x00,
+    0x00, 0x0f, 0x80, 0x00, 0x00, 0x0f, 0x80, 0x00, 0x00, 0x0f, 0x8c, 0x00,
+    0x00, 0x0f, 0x80, 0x00, 0x04, 0x0f, 0x00, 0x70, 0x00, 0x0f, 0x8f, 0x00,
+    0x00, 0x07, 0xff, 0x89, 0x00, 0x00, 0x00, 0xf0, 0x81, 0x00, 0x00, 0x0f,
+    0x80, 0x00, 0x00, 0x0f, 0x8c, 0x00, 0x00, 0x0f, 0x80, 0x00, 0x04, 0x0f,
+    0x00, 0x70, 0x00, 0xf0, 0x8f, 0x00, 0x00, 0x07, 0xff, 0x89, 0x00, 0x00,
+    0x00, 0xf0, 0x80, 0x00, 0x00, 0xf0, 0x81, 0x00, 0x00, 0x0f, 0x8c, 0x00,
+    0x00, 0x0f, 0x80, 0x00, 0x04, 0xf0, 0x00, 0x70, 0x00, 0xf0, 0x8f, 0x00,
+    0x00, 0x07, 0xff, 0x89, 0x00, 0x00, 0x04, 0x0f, 0x00, 0x00, 0xff, 0xf0,
+    0x81, 0x00, 0x00, 0xff, 0x80, 0x00, 0x02, 0xff, 0x00, 0xff, 0x80, 0x00,
+    0x02, 0xff, 0x00, 0x00, 0x80, 0xff, 0x09, 0x0f, 0x00, 0xff, 0x00, 0xf0,
+    0x00, 0xff, 0x00, 0x00, 0x0f, 0x8e, 0x00, 0x00, 0x07, 0xff, 0x89, 0x00,
+    0x00, 0x04, 0x0f, 0x00, 0x00, 0xff, 0xf0, 0x80, 0x00, 0x01, 0xf0, 0xff,
+    0x80, 0x00, 0x02, 0xff, 0x00, 0xff, 0x80, 0x00, 0x02, 0xff, 0x00, 0x00,
+    0x80, 0xff, 0x09, 0xf0, 0x00, 0xff, 0x00, 0xf0, 0x00, 0xff, 0x00, 0x00,
+    0x0f, 0x8e, 0x00, 0x00, 0x07, 0xff, 0x88, 0x00, 0x00, 0x00, 0xf0, 0x80,
+    0x00, 0x01, 0xff, 0x0f, 0x80, 0x00, 0x01, 0xf0, 0xff, 0x80, 0x00, 0x08,
+    0xff, 0x00, 0xff, 0xff, 0x00, 0xff, 0xff, 0x00, 0xff, 0x80, 0x00, 0x09,
+    0xff, 0x00, 0xff, 0x00, 0x00, 0x0f, 0xff, 0x00, 0x00, 0xf0, 0x8e, 0x00,
+    0x00, 0x07, 0xff, 0x88, 0x00, 0x00, 0x00, 0xf0, 0x80, 0x00, 0x01, 0xff,
+    0x0f, 0x80, 0x00, 0x01, 0xf0, 0xff, 0x80, 0x00, 0x08, 0xff, 0x00, 0xff,
+    0xff, 0x00, 0xff, 0xff, 0x00, 0xff, 0x80, 0x00, 0x09, 0xff, 0x00, 0xff,
+    0x00, 0x00, 0x0f, 0xff, 0x00, 0x00, 0xf0, 0x8e, 0x00, 0x00, 0x07, 0xff,
+    0x88, 0x00, 0x00, 0x00, 0xf0, 0x80, 0x00, 0x01, 0xff, 0x0f, 0x80, 0x00,
+    0x01, 0xf0, 0xff, 0x80, 0x00, 0x08, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00,
+    0xff, 0x00, 0xff, 0x80, 0x00, 0x09, 0xff, 0x00, 0xff, 0xff, 0x00, 0x0f,
+    0xff, 0x00, 0x00, 0xf0, 0x8e, 0x00, 0x00, 0x07, 0xff, 0x88, 0x00, 0x00,
+    0x00, 0xf0, 0x80, 0x00, 0x01, 0xff, 0x0f, 0x80, 0x00, 0x01, 0xf0, 0xff,
+    0x80, 0x00, 0x08, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff,
+    0x80, 0x00, 0x09, 0xff, 0x00, 0xff, 0xff, 0x00, 0x0f, 0xff, 0x00, 0x00,
+    0xf0, 0x8e, 0x00, 0x00, 0x07, 0xff, 0x88, 0x00, 0x00, 0x00, 0xf0, 0x80,
+    0x00, 0x01, 0xff, 0x0f, 0x80, 0x00, 0x01, 0xf0, 0xff, 0x80, 0x00, 0x08,
+    0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x80, 0x00, 0x09,
+    0xff, 0x00, 0xff, 0x00, 0xff, 0x0f, 0xff, 0x00, 0x00, 0xf0, 0x8e, 0x00,
+    0x00, 0x07, 0xff, 0x88, 0x00, 0x00, 0x00, 0xf0, 0x80, 0x00, 0x01, 0xff,
+    0x0f, 0x80, 0x00, 0x01, 0xf0, 0xff, 0x80, 0x00, 0x08, 0xff, 0x00, 0xff,
+    0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x80, 0x00, 0x09, 0xff, 0x00, 0xff,
+    0x00, 0xff, 0x0f, 0xff, 0x00, 0x00, 0xf0, 0x8e, 0x00, 0x00, 0x07, 0xff,
+    0x88, 0x00, 0x00, 0x00, 0xf0, 0x80, 0x00, 0x01, 0xff, 0x0f, 0x80, 0x00,
+    0x01, 0xf0, 0xff, 0x80, 0x00, 0x08, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00,
+    0xff, 0x00, 0xff, 0x80, 0x00, 0x09, 0xff, 0x00, 0xff, 0x00, 0x00, 0xff,
+    0xff, 0x00, 0x00, 0xf0, 0x8e, 0x00, 0x00, 0x07, 0xff, 0x89, 0x00, 0x00,
+    0x04, 0x0f, 0x00, 0x00, 0xff, 0xf0, 0x80, 0x00, 0x01, 0xf0, 0xff, 0x80,
+    0x00, 0x08, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x80,
+    0x00, 0x09, 0xff, 0x00, 0xff, 0x00, 0xf0, 0xff, 0xff, 0x00, 0x00, 0x0f,
+    0x8e, 0x00, 0x00, 0x07, 0xff, 0x89, 0x00, 0x00, 0x04, 0x0f, 0x00, 0x00,
+    0xff, 0xf0, 0x81, 0x00, 0x00, 0xff, 0x80, 0x00, 0x02, 0xff, 0x00, 0xff,
+    0x80, 0x00, 0x02, 0xff, 0x00, 0xff, 0x80, 0x00, 0x09, 0xff, 0x00, 0xff,
+    0x00, 0xf0, 0x00, 0xff, 0x00, 0x00, 0x0f, 0x8e, 0x00, 0x00, 0x07, 0xff,
+    0x89, 0x00, 0x00, 0x04, 0xf0, 0x00, 0x00, 0xff, 0xf0, 0x81, 0x00, 0x00,
+    0xff, 0x80, 0x00, 0x02, 0xff, 0x00, 0xff, 0x80, 0x00, 0x02, 0xff, 0x00,
+    0xff, 0x80, 0x00, 0x08, 0xff, 0x00, 0xff, 0x00, 0xf0, 0x00, 0xff, 0x00,
+    0xf0, 0x8f, 0x00, 0x00, 0x07, 0xff, 0x89, 0x00, 0x00, 0x02, 0xf0, 0x00,
+    0x00, 0x82, 0xff, 0x01, 0x00, 0x0f, 0x80, 0xff, 0x02, 0x00, 0x00, 0xff,
+    0x80, 0x00, 0x02, 0xff, 0x00, 0x00, 0x80, 0xff, 0x08, 0x0f, 0x00, 0xff,
+    0x00, 0x0f, 0x00, 0xff, 0x00, 0xf0, 0x8f, 0x00, 0x00, 0x07, 0xff, 0x8a,
+    0x00, 0x00, 0x01, 0x0f, 0x00, 0x82, 0xff, 0x01, 0x00, 0x0f, 0x80, 0xff,
+    0x02, 0x00, 0x00, 0xff, 0x80, 0x00, 0x02, 0xff, 0x00, 0x00, 0x80, 0xff,
+    0x08, 0x0f, 0x00, 0xff, 0x00, 0x0f, 0x00, 0xff, 0x00, 0x0f, 0x8f, 0x00,
+    0x00, 0x07, 0xff, 0x8a, 0x00, 0x00, 0x00, 0xf0, 0x80, 0x00, 0x00, 0xf0,
+    0x80, 0x00, 0x00, 0xf0, 0x8b, 0x00, 0x00, 0xf0, 0x80, 0x00, 0x04, 0xf0,
+    0x00, 0x00, 0x70, 0xf0, 0x90, 0x00, 0x00, 0x07, 0xff, 0x8b, 0x00, 0x00,
+    0x03, 0x0f, 0x00, 0x00, 0xf0, 0x80, 0x00, 0x00, 0xf0, 0x8b, 0x00, 0x00,
+    0xf0, 0x80, 0x00, 0x04, 0xf0, 0x00, 0x00, 0x70, 0x0f, 0x90, 0x00, 0x00,
+    0x07, 0xff, 0x8b, 0x00, 0x00, 0x00, 0xf0, 0x80, 0x00, 0x00, 0x0f, 0x80,
+    0x00, 0x00, 0x0f, 0x8a, 0x00, 0x00, 0x0f, 0x80, 0x00, 0x03, 0x0f, 0x00,
+    0x00, 0xf0, 0x91, 0x00, 0x00, 0x07, 0xff, 0x8c, 0x00, 0x00, 0x03, 0x0f,
+    0x00, 0x00, 0xf0, 0x80, 0x00, 0x00, 0x0f, 0x8a, 0x00, 0x03, 0x0f, 0x00,
+    0x00, 0xf0, 0x80, 0x00, 0x00, 0x7f, 0x91, 0x00, 0x00, 0x07, 0xff, 0x8c,
+    0x00, 0x00, 0x07, 0xf0, 0x0f, 0x00, 0x00, 0x0f, 0x00, 0x00, 0xf0, 0x89,
+    0x00, 0x00, 0xf0, 0x80, 0x00, 0x04, 0x0f, 0x00, 0x00, 0xff, 0x70, 0x91,
+    0x00, 0xff, 0x8e, 0x00, 0x77, 0x07, 0xf7, 0x77, 0x77, 0xf7, 0x7f, 0x77,
+    0x77, 0x7f, 0x88, 0x77, 0x08, 0x7f, 0x77, 0x77, 0xff, 0x77, 0x77, 0xf7,
+    0x77, 0x77, 0xff, 0xa2, 0x00, 0x00, 0x97, 0xff, 0xff, 0xa6, 0x00, 0x00,
+    0x06, 0xff, 0x0f, 0x00, 0xff, 0x00, 0x00, 0x0f, 0x86, 0x00, 0x06, 0x0f,
+    0x00, 0xf0, 0x0f, 0x00, 0xff, 0x0f, 0xff, 0xa8, 0x00, 0x00, 0x05, 0xf0,
+    0xff, 0x00, 0xff, 0x00, 0xf0, 0x85, 0x00, 0x05, 0xf0, 0x00, 0xf0, 0x0f,
+    0xf0, 0xff, 0xff, 0xac, 0x00, 0x00, 0x04, 0xff, 0x0f, 0xff, 0x0f, 0xff,
+    0x83, 0x00, 0x05, 0xf0, 0x0f, 0xff, 0x0f, 0xff, 0x0f, 0xff, 0xae, 0x00,
+    0x00, 0x00, 0xf0, 0x81, 0xff, 0x00, 0x0f, 0x80, 0x00, 0x82, 0xff, 0xff,
+    0xb3, 0x00, 0x00, 0x00, 0xf0, 0x84, 0xff, 0xff, 0xff, 0xff, 0x00, 0xff,
+    0x26, 0xc6, 0x00, 0x9b, 0x77, 0x9b, 0x00, 0x9b, 0x77, 0x9b, 0x00, 0x9b,
+    0x77, 0x9b, 0x00, 0x9b, 0x77, 0x9b, 0x00, 0x9b, 0x77, 0xaf, 0x00, 0x00,
+    0x07, 0x89, 0x00, 0x04, 0xf0, 0xff, 0x00, 0xf0, 0xff, 0x88, 0x00, 0x00,
+    0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x04, 0xf0, 0xff, 0x00, 0x00,
+    0x0f, 0x88, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x04,
+    0xf0, 0xff, 0x00, 0xf0, 0xff, 0x88, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00,
+    0x07, 0x89, 0x00, 0x05, 0xf0, 0xff, 0x00, 0xff, 0xff, 0x0f, 0x87, 0x00,
+    0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x04, 0xf0, 0xff, 0x00,
+    0x00, 0xf0, 0x88, 0x00, 0x00, 0x70, 0xaf, 0x00, 0x00, 0x07, 0x89, 0x00,
+    0x05, 0x0f, 0x00, 0x0f, 0x0f, 0x00, 0x0f, 0x87, 0x00, 0x00, 0x70, 0x9b,
+    0x00, 0x00, 0x07, 0x89, 0x00, 0x04, 0x0f, 0x00, 0x0f, 0xf0, 0x0f, 0x88,
+    0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x05, 0x0f, 0x00,
+    0x0f, 0x0f, 0x00, 0x0f, 0x87, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07,
+    0x89, 0x00, 0x05, 0x0f, 0x00, 0x0f, 0x00, 0x00, 0x0f, 0x87, 0x00, 0x00,
+    0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x04, 0x0f, 0x00, 0x0f, 0x00,
+    0xff, 0x88, 0x00, 0x00, 0x70, 0xaf, 0x00, 0x00, 0x07, 0x89, 0x00, 0x05,
+    0x0f, 0xf0, 0x0f, 0x0f, 0xf0, 0x0f, 0x87, 0x00, 0x00, 0x70, 0x9b, 0x00,
+    0x00, 0x07, 0x89, 0x00, 0x04, 0x0f, 0xf0, 0x0f, 0x00, 0x0f, 0x88, 0x00,
+    0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x05, 0x0f, 0xf0, 0x0f,
+    0x00, 0x00, 0x0f, 0x87, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89,
+    0x00, 0x04, 0x0f, 0xf0, 0x0f, 0x00, 0xf0, 0x88, 0x00, 0x00, 0x70, 0x9b,
+    0x00, 0x00, 0x07, 0x89, 0x00, 0x04, 0x0f, 0xf0, 0x0f, 0xf0, 0xf0, 0x88,
+    0x00, 0x00, 0x70, 0xaf, 0x00, 0x00, 0x07, 0x89, 0x00, 0x83, 0x0f, 0x87,
+    0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x80, 0x0f, 0x01,
+    0x00, 0x0f, 0x88, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00,
+    0x80, 0x0f, 0x01, 0xf0, 0xff, 0x88, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00,
+    0x07, 0x89, 0x00, 0x80, 0x0f, 0x01, 0x00, 0xff, 0x88, 0x00, 0x00, 0x70,
+    0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x81, 0x0f, 0x00, 0xf0, 0x88, 0x00,
+    0x00, 0x70, 0xaf, 0x00, 0x00, 0x07, 0x89, 0x00, 0x05, 0xff, 0x00, 0x0f,
+    0xff, 0x00, 0x0f, 0x87, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89,
+    0x00, 0x04, 0xff, 0x00, 0x0f, 0x00, 0x0f, 0x88, 0x00, 0x00, 0x70, 0x9b,
+    0x00, 0x00, 0x07, 0x89, 0x00, 0x03, 0xff, 0x00, 0x0f, 0x0f, 0x89, 0x00,
+    0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x05, 0xff, 0x00, 0x0f,
+    0x00, 0x00, 0x0f, 0x87, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89,
+    0x00, 0x05, 0xff, 0x00, 0x0f, 0xff, 0xff, 0x0f, 0x87, 0x00, 0x00, 0x70,
+    0xaf, 0x00, 0x00, 0x07, 0x89, 0x00, 0x05, 0x0f, 0x00, 0x0f, 0x0f, 0x00,
+    0x0f, 0x87, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x04,
+    0x0f, 0x00, 0x0f, 0x00, 0x0f, 0x88, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00,
+    0x07, 0x89, 0x00, 0x03, 0x0f, 0x00, 0x0f, 0x0f, 0x89, 0x00, 0x00, 0x70,
+    0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x05, 0x0f, 0x00, 0x0f, 0x0f, 0x00,
+    0x0f, 0x87, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x04,
+    0x0f, 0x00, 0x0f, 0x00, 0xf0, 0x88, 0x00, 0x00, 0x70, 0xaf, 0x00, 0x00,
+    0x07, 0x89, 0x00, 0x04, 0xf0, 0xff, 0x00, 0xf0, 0xff, 0x88, 0x00, 0x00,
+    0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x04, 0xf0, 0xff, 0x00, 0xf0,
+    0xff, 0x88, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x05,
+    0xf0, 0xff, 0x00, 0xff, 0xff, 0x0f, 0x87, 0x00, 0x00, 0x70, 0x9b, 0x00,
+    0x00, 0x07, 0x89, 0x00, 0x04, 0xf0, 0xff, 0x00, 0xf0, 0xff, 0x88, 0x00,
+    0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x89, 0x00, 0x04, 0xf0, 0xff, 0x00,
+    0x00, 0xf0, 0x88, 0x00, 0x00, 0x70, 0xaf, 0x00, 0x00, 0x07, 0x99, 0x00,
+    0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0x9b, 0x00,
+    0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00,
+    0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0xaf, 0x00,
+    0x9b, 0x77, 0x9b, 0x00, 0x9b, 0x77, 0x9b, 0x00, 0x9b, 0x77, 0x9b, 0x00,
+    0x9b, 0x77, 0x9b, 0x00, 0x9b, 0x77, 0xff, 0x30, 0x02, 0x00, 0x9b, 0x77,
+    0x9b, 0x00, 0x9b, 0x77, 0x9b, 0x00, 0x9b, 0x77, 0x9b, 0x00, 0x9b, 0x77,
+    0x9b, 0x00, 0x9b, 0x77, 0xaf, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07,
+    0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0xaf, 0x00, 0x00, 0x07,
+    0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07,
+    0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0xaf, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07,
+    0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07,
+    0x99, 0x00, 0x00, 0x70, 0xaf, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07,
+    0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0xaf, 0x00, 0x00, 0x07,
+    0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07,
+    0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0xaf, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07,
+    0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07,
+    0x99, 0x00, 0x00, 0x70, 0xaf, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07,
+    0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0xaf, 0x00, 0x00, 0x07,
+    0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07,
+    0x99, 0x00, 0x00, 0x70, 0x9b, 0x00, 0x00, 0x07, 0x99, 0x00, 0x00, 0x70,
+    0xaf, 0x00, 0x9b, 0x77, 0x9b, 0x00, 0x9b, 0x77, 0x9b, 0x00, 0x9b, 0x77,
+    0x9b, 0x00, 0x9b, 0x77, 0x9b, 0x00, 0x9b, 0x77, 0xff, 0x21, 0x16, 0x00,
+    0xff, 0xaa, 0x00, 0x77, 0x91, 0x00, 0xfa, 0x77, 0x01, 0x07, 0x00, 0x81,
+    0x77, 0x0d, 0x00, 0x00, 0x70, 0x00, 0x00, 0x77, 0x07, 0x00, 0x77, 0x00,
+    0x00, 0x70, 0x77, 0x70, 0x87, 0x77, 0x01, 0x07, 0x00, 0x81, 0x77, 0x11,
+    0x00, 0x00, 0x77, 0x00, 0x00, 0x70, 0x00, 0x00, 0x70, 0x77, 0x70, 0x77,
+    0x00, 0x00, 0x70, 0x00, 0x00, 0x70, 0xf6, 0x77, 0x91, 0x00, 0xfa, 0x77,
+    0x02, 0x70, 0x77, 0x70, 0x80, 0x77, 0x0d, 0x70, 0x77, 0x77, 0x70, 0x77,
+    0x70, 0x70, 0x77, 0x70, 0x70, 0x77, 0x77, 0x07, 0x07, 0x87, 0x77, 0x02,
+    0x70, 0x77, 0x70, 0x80, 0x77, 0x03, 0x70, 0x77, 0x70, 0x70, 0x81, 0x77,
+    0x02, 0x70, 0x07, 0x70, 0x80, 0x77, 0x01, 0x70, 0x70, 0xf8, 0x77, 0x91,
+    0x00, 0xfa, 0x77, 0x14, 0x70, 0x07, 0x70, 0x70, 0x77, 0x70, 0x00, 0x00,
+    0x77, 0x70, 0x77, 0x70, 0x70, 0x77, 0x70, 0x70, 0x77, 0x77, 0x70, 0x77,
+    0x70, 0x81, 0x77, 0x00, 0x70, 0x81, 0x77, 0x0a, 0x70, 0x07, 0x70, 0x70,
+    0x77, 0x70, 0x70, 0x77, 0x70, 0x00, 0x00, 0x80, 0x77, 0x08, 0x70, 0x77,
+    0x70, 0x77, 0x77, 0x07, 0x77, 0x00, 0x00, 0xf7, 0x77, 0x91, 0x00, 0xfa,
+    0x77, 0x80, 0x70, 0x01, 0x07, 0x07, 0x80, 0x77, 0x0c, 0x70, 0x70, 0x77,
+    0x70, 0x07, 0x00, 0x70, 0x00, 0x00, 0x77, 0x70, 0x77, 0x70, 0x86, 0x77,
+    0x80, 0x70, 0x04, 0x07, 0x07, 0x77, 0x00, 0x00, 0x80, 0x77, 0x08, 0x70,
+    0x77, 0x07, 0x77, 0x77, 0x70, 0x77, 0x77, 0x00, 0x80, 0x77, 0x00, 0x70,
+    0xf6, 0x77, 0x91, 0x00, 0xfa, 0x77, 0x04, 0x00, 0x77, 0x70, 0x77, 0x70,
+    0x80, 0x77, 0x0c, 0x70, 0x70, 0x77, 0x70, 0x77, 0x77, 0x70, 0x70, 0x77,
+    0x77, 0x00, 0x00, 0x70, 0x81, 0x77, 0x00, 0x70, 0x81, 0x77, 0x10, 0x00,
+    0x77, 0x70, 0x77, 0x70, 0x77, 0x70, 0x77, 0x70, 0x77, 0x77, 0x70, 0x77,
+    0x70, 0x77, 0x77, 0x70, 0x80, 0x77, 0x03, 0x70, 0x77, 0x77, 0x70, 0xf6,
+    0x77, 0x91, 0x00, 0xfa, 0x77, 0x14, 0x70, 0x77, 0x70, 0x07, 0x07, 0x77,
+    0x70, 0x77, 0x70, 0x70, 0x77, 0x70, 0x77, 0x07, 0x77, 0x70, 0x77, 0x77,
+    0x70, 0x77, 0x70, 0x86, 0x77, 0x0c, 0x70, 0x77, 0x70, 0x07, 0x07, 0x77,
+    0x70, 0x77, 0x70, 0x70, 0x77, 0x70, 0x07, 0x80, 0x77, 0x07, 0x70, 0x77,
+    0x70, 0x77, 0x70, 0x70, 0x77, 0x70, 0xf6, 0x77, 0x91, 0x00, 0xfa, 0x77,
+    0x14, 0x07, 0x00, 0x77, 0x70, 0x77, 0x70, 0x07, 0x00, 0x77, 0x00, 0x00,
+    0x77, 0x00, 0x70, 0x77, 0x00, 0x00, 0x70, 0x70, 0x77, 0x70, 0x86, 0x77,
+    0x16, 0x07, 0x00, 0x77, 0x70, 0x77, 0x70, 0x00, 0x00, 0x77, 0x07, 0x00,
+    0x77, 0x70, 0x77, 0x77, 0x07, 0x00, 0x77, 0x07, 0x00, 0x77, 0x07, 0x00,
+    0xf7, 0x77, 0x91, 0x00, 0xff, 0xaa, 0x00, 0x77, 0x91, 0x00, 0xff, 0xaa,
+    0x00, 0x77, 0xff, 0x0d, 0x0c, 0x00,
+};
+
+#endif // BOOT_SCREEN_H
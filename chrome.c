@@ -0,0 +1,134 @@
+#include "chrome.h"
+#include "vga16_graphics.h"
+#include <stdio.h>
+#include <string.h>
+
+// ==================================================
+// === lumon logo : Pass the center of the logo and dimension (w, h)
+// ==================================================
+void draw_lumon_logo(int cx, int cy, int logo_w, int logo_h) {
+  char fill_color = DARK_BLUE; // Dark blue for the globe fill
+  char line_color = WHITE; // Bright white for outlines and text
+
+  // Calculate radii for the ovals
+  short outer_rx = logo_w / 2;
+  short ry = logo_h / 2; //
+  short middle_rx = (short)(outer_rx * 0.75);
+  short inner_rx = (short)(outer_rx * 0.5);
+
+  drawOval(cx, cy, outer_rx, ry, line_color);  // Outer oval
+  drawOval(cx, cy, middle_rx, ry, line_color); // Middle oval
+  drawOval(cx, cy, inner_rx, ry, line_color);  // Inner oval
+
+  drawHLine(cx - middle_rx, cy - (ry - 5), logo_w * 0.75, line_color);
+  drawHLine(cx - middle_rx, cy + (ry - 5), logo_w * 0.75, line_color);
+
+  char text_str[] = "LUMON";
+  setCursor(cx - (middle_rx + 2), cy - 5);
+  setTextSize(2);
+  setTextColor(WHITE);
+  writeString(text_str);
+}
+
+void draw_box_frame(int x, int y, int w, int h, int idx) {
+
+  // Top Rect (Index Display)
+  char index[3] = {0, 0, 0}; // Increased size for two digits + null terminator
+  // Format the index as a two-digit string (e.g., 00, 01, 02, 03)
+  index[0] = '0'; // Always start with '0'
+  index[1] = '0' + idx;
+  drawRect(x, y, w, h, CYAN);
+  setCursor(x + (w / 2) - 4,
+            y + (h / 2) - 4); // Adjust cursor slightly for two digits
+  setTextSize(1);
+  setTextColor(WHITE);
+  writeString(index);
+
+  // Bottom Rect (Progress Bar)
+  int bottom_y = y + h + 2;
+  // Draw the background/outline of the progress bar
+  drawRect(x, bottom_y, w, h, CYAN); // Outline is CYAN
+}
+
+void draw_box_value(int x, int y, int w, int h, int percentage) {
+  int bottom_y = y + h + 2;
+  int fill_w = (w * percentage) / 100;
+  // Ensure fill width doesn't exceed total width
+  if (fill_w > w) {
+    fill_w = w;
+  }
+  if (fill_w < 0) {
+    fill_w = 0;
+  }
+
+  // Draw the filled portion representing the percentage
+  if (fill_w > 0) {
+    fillRect(x, bottom_y, fill_w, h, WHITE); // Fill is WHITE
+  }
+
+  // Draw the percentage text
+  char percent_str[5]; // Buffer for percentage string (e.g., "100%")
+  sprintf(percent_str, "%d%%", percentage); // Format the percentage
+  int text_width = strlen(percent_str) * 6; // Assuming font width of 6 pixels
+  int text_x = x + 5;
+  int text_y = bottom_y + (h / 2) - 4; // Adjust vertical position
+
+  setCursor(text_x, text_y);
+  setTextSize(1);
+  setTextColor(BLACK);
+  writeString(percent_str);
+}
+
+// ==================================================
+// === static layers -- chrome rendered once, restored by block copy
+// ==================================================
+static unsigned char header_pixels[HEADER_W / 2 * HEADER_H];
+static unsigned char footer_pixels[FOOTER_W / 2 * FOOTER_H];
+static unsigned char box_pixels[5][WFDM_W / 2 * BOX_LAYER_H];
+StaticLayer header_layer, footer_layer, box_layers[5];
+
+static void render_header(void *arg) {
+  drawRect(PROGRESS_X, PROGRESS_Y, PROGRESS_W, PROGRESS_H, CYAN);
+  draw_lumon_logo(LOGO_CX, LOGO_CY, LOGO_W, LOGO_H);
+}
+
+static void render_footer(void *arg) {
+  fillRect(GRID_START_X, FOOTER_Y, FOOTER_W, FOOTER_H, CYAN);
+  setCursor((FOOTER_W / 2) - 40, FOOTER_Y + 1);
+  setTextColor(BLACK);
+  setTextSize(1);
+  writeString("0x5D9EA : 0xB57135");
+}
+
+static void render_box(void *arg) {
+  int i = (int)(intptr_t)arg;
+  draw_box_frame(WFDM_X + WFDM_SPACING * i, WFDM_Y, WFDM_W, WFDM_H, i);
+}
+
+void chrome_init(void) {
+  static_layer_init(&header_layer, header_pixels, PROGRESS_X, HEADER_Y,
+                    HEADER_W, HEADER_H, render_header, NULL);
+  static_layer_init(&footer_layer, footer_pixels, GRID_START_X, FOOTER_Y,
+                    FOOTER_W, FOOTER_H, render_footer, NULL);
+  for (int i = 0; i < 5; i++) {
+    static_layer_init(&box_layers[i], box_pixels[i],
+                      WFDM_X + WFDM_SPACING * i, WFDM_Y, WFDM_W, BOX_LAYER_H,
+                      render_box, (void *)(intptr_t)i);
+  }
+}
+
+void chrome_draw(void) {
+  static_layer_restore(&header_layer);
+  static_layer_restore(&footer_layer);
+  for (int i = 0; i < 5; i++) {
+    static_layer_restore(&box_layers[i]);
+  }
+}
+
+void chrome_capture(void) {
+  static_layer_capture(&header_layer);
+  static_layer_capture(&footer_layer);
+  for (int i = 0; i < 5; i++) {
+    static_layer_capture(&box_layers[i]);
+  }
+}
@@ -0,0 +1,52 @@
+#include "game_state.h"
+#include "static_layer.h"
+
+#ifndef CHROME_H
+#define CHROME_H
+
+// The screen furniture around the grid: progress bar, Lumon logo, footer
+// bar and the woe, frolic, dread and malice boxes. The parts that never
+// change are static layers; the game thread draws the values over them.
+// Shared by the firmware and the host boot screen baker.
+
+// Layout
+#define PROGRESS_X (GRID_START_X + 10)
+#define PROGRESS_Y 20
+#define PROGRESS_W (COLS * CELL_WIDTH)
+#define PROGRESS_H 30
+#define LOGO_W 70
+#define LOGO_H 40
+#define LOGO_CX (PROGRESS_W - 10) // to the right of the progress bar
+#define LOGO_CY (PROGRESS_Y + PROGRESS_H / 2)
+#define FOOTER_Y 460
+#define WFDM_X 40 // woe, frolic, dread and malice boxes
+#define WFDM_Y 420
+#define WFDM_W 60
+#define WFDM_H 10
+#define WFDM_SPACING (WFDM_W + 60)
+
+// Header: the progress bar outline with the logo that overlaps its end
+#define HEADER_Y (LOGO_CY - LOGO_H / 2)
+#define HEADER_W (VGA_WIDTH - PROGRESS_X)
+#define HEADER_H (LOGO_H + 1)
+#define FOOTER_W (COLS * CELL_WIDTH)
+#define FOOTER_H 10
+#define BOX_LAYER_H (2 * WFDM_H + 2)
+
+extern StaticLayer header_layer, footer_layer, box_layers[5];
+
+// Set up the layers; nothing is drawn yet
+void chrome_init(void);
+// Put every layer on screen, rendering any not cached yet
+void chrome_draw(void);
+// The screen already shows the chrome (e.g. the decoded boot screen): fill
+// the layer caches from it instead of rendering them
+void chrome_capture(void);
+
+void draw_lumon_logo(int cx, int cy, int logo_w, int logo_h);
+// The parts of a box that never change: both outlines and the index
+void draw_box_frame(int x, int y, int w, int h, int idx);
+// The box's percentage, over its frame
+void draw_box_value(int x, int y, int w, int h, int percentage);
+
+#endif // CHROME_H
@@ -1,43 +1,221 @@
 #include "game_state.h"
+#include "task_pool.h"
 #include "vga16_graphics.h"
 #include <stdbool.h> // Include for bool type
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
-static inline bool is_valid(int r, int c) {
-  return r >= 0 && r < ROWS && c >= 0 && c < COLS;
+// Backing storage for the grid, sized at build time
+static Number cell_arena[GRID_MAX_CELLS];
+
+static inline bool is_valid(GameState *state, int r, int c) {
+  return r >= 0 && r < state->rows && c >= 0 && c < state->cols;
+}
+
+// === grid index bookkeeping ===
+static inline bool bit_test(const uint32_t *bits, int i) {
+  return (bits[i >> 5] >> (i & 31)) & 1;
+}
+static inline void bit_set(uint32_t *bits, int i) {
+  bits[i >> 5] |= 1u << (i & 31);
+}
+static inline void bit_clear(uint32_t *bits, int i) {
+  bits[i >> 5] &= ~(1u << (i & 31));
+}
+
+// === bad number groups (union-find) ===
+static inline void group_make_single(BadGroups *groups, int idx) {
+  groups->parent[idx] = idx;
+  groups->size[idx] = 1;
+  groups->next[idx] = idx;
 }
 
-// Helper function for DFS grouping
-void game_state_init(GameState *state, int seed) {
+int bad_group_find(GameState *state, int idx) {
+  uint16_t *parent = state->groups.parent;
+  while (parent[idx] != idx) {
+    parent[idx] = parent[parent[idx]]; // path halving
+    idx = parent[idx];
+  }
+  return idx;
+}
+
+int bad_group_size(GameState *state, int idx) {
+  return state->groups.size[bad_group_find(state, idx)];
+}
+
+static void group_union(GameState *state, int a, int b) {
+  BadGroups *groups = &state->groups;
+  a = bad_group_find(state, a);
+  b = bad_group_find(state, b);
+  if (a == b) {
+    return;
+  }
+  // union by size
+  if (groups->size[a] < groups->size[b]) {
+    int t = a;
+    a = b;
+    b = t;
+  }
+  groups->parent[b] = a;
+  groups->size[a] += groups->size[b];
+  // splice the two circular member lists
+  uint16_t t = groups->next[a];
+  groups->next[a] = groups->next[b];
+  groups->next[b] = t;
+  groups->group_count--;
+}
+
+// Join a bad cell with whichever of its 4 neighbours are bad
+static void group_join_neighbours(GameState *state, int idx) {
+  int col = idx % state->cols;
+  const uint32_t *bad = state->index.bad;
+  if (col > 0 && bit_test(bad, idx - 1))
+    group_union(state, idx, idx - 1);
+  if (col < state->cols - 1 && bit_test(bad, idx + 1))
+    group_union(state, idx, idx + 1);
+  if (idx >= state->cols && bit_test(bad, idx - state->cols))
+    group_union(state, idx, idx - state->cols);
+  if (idx + state->cols < state->rows * state->cols &&
+      bit_test(bad, idx + state->cols))
+    group_union(state, idx, idx + state->cols);
+}
+
+static void group_add(GameState *state, int idx) {
+  group_make_single(&state->groups, idx);
+  state->groups.group_count++;
+  group_join_neighbours(state, idx);
+}
+
+// Union-find cannot delete, so the group that loses a cell is taken apart
+// and its remaining members are re-joined. Only that group is touched.
+static void group_remove(GameState *state, int idx) {
+  BadGroups *groups = &state->groups;
+  static uint16_t members[GRID_MAX_CELLS];
+  int count = 0;
+  int m = idx;
+  do {
+    members[count++] = m;
+    m = groups->next[m];
+  } while (m != idx);
+
+  groups->group_count--;
+  for (int i = 0; i < count; i++) {
+    group_make_single(groups, members[i]);
+  }
+  for (int i = 0; i < count; i++) {
+    if (members[i] != idx) {
+      groups->group_count++;
+    }
+  }
+  for (int i = 0; i < count; i++) {
+    if (members[i] != idx) {
+      group_join_neighbours(state, members[i]);
+    }
+  }
+}
+
+static void mark_dirty(GameState *state, int idx) {
+  GridIndex *index = &state->index;
+  if (!bit_test(index->dirty, idx)) {
+    bit_set(index->dirty, idx);
+    index->dirty_list[index->dirty_count++] = idx;
+  }
+}
+
+// All changes to a cell's bad flag go through here to keep the index and
+// total_bad_numbers in step
+static void set_bad(GameState *state, int idx, bool bad) {
+  Number *num = &state->cells[idx];
+  if (num_is_bad(num) == bad) {
+    return;
+  }
+  num_set_bad(num, bad);
+  if (bad) {
+    bit_set(state->index.bad, idx);
+    state->total_bad_numbers++;
+    group_add(state, idx);
+  } else {
+    bit_clear(state->index.bad, idx);
+    state->total_bad_numbers--;
+    group_remove(state, idx);
+  }
+}
+
+// Queue a cell for the start-of-frame refresh
+static void track_touched(GameState *state, int idx) {
+  GridIndex *index = &state->index;
+  if (!bit_test(index->touched, idx)) {
+    bit_set(index->touched, idx);
+    index->touched_list[index->touched_count++] = idx;
+  }
+}
+
+static void mark_touched(GameState *state, int idx, int boid) {
+  num_set_touched(&state->cells[idx], boid);
+  track_touched(state, idx);
+  mark_dirty(state, idx);
+}
+
+// Refined numbers stop counting as bad straight away; they get a new value
+// at the start of the next frame. A cell whose state changes is redrawn
+// this frame.
+static void refine_cell(GameState *state, int idx) {
+  Number *num = &state->cells[idx];
+  if (!num_is_refined(num) || num_is_bad(num)) {
+    mark_dirty(state, idx);
+  }
+  num_set_refined(num);
+  set_bad(state, idx, false);
+  track_touched(state, idx);
+}
+
+void game_state_init(GameState *state, int rows, int cols, int seed) {
   // Use a combination of the seed and a fixed value to ensure more randomness
-  srand(seed + 0x5D9EA); // Add a fixed value to make the seed more unique
+  rng_seed(&state->rng[0], seed + 0x5D9EA);
+  rng_seed(&state->rng[1], seed + 0xB57135);
+  Rng *rng = &state->rng[0];
+
+  // Clamp the grid to what the arena can hold
+  if (cols < 1)
+    cols = 1;
+  if (cols > GRID_MAX_CELLS)
+    cols = GRID_MAX_CELLS;
+  if (rows < 1)
+    rows = 1;
+  if (rows * cols > GRID_MAX_CELLS)
+    rows = GRID_MAX_CELLS / cols;
+  state->rows = rows;
+  state->cols = cols;
+  state->cells = cell_arena;
+  memset(&state->index, 0, sizeof(state->index));
+  state->groups.group_count = 0;
+  for (int i = 0; i < rows * cols; i++) {
+    group_make_single(&state->groups, i);
+  }
 
   state->total_bad_numbers = 0;
   state->progress_bar.current_progress = 25;
   state->progress_bar.progress_anim_step = 0;
+  state->progress_bar.anim_state = ANIMATION_IDLE;
 
-  for (int row = 0; row < ROWS; row++) {
-    for (int col = 0; col < COLS; col++) {
+  for (int row = 0; row < rows; row++) {
+    for (int col = 0; col < cols; col++) {
+      Number *num = game_cell(state, row, col);
       // Use a different random number for each field to ensure more randomness
-      int random_number1 = rand();
-      int random_number2 = rand();
-      state->state[row][col].number = random_number1 % 10;
-      state->state[row][col].x = GRID_START_X + (col * CELL_WIDTH);
-      state->state[row][col].y = GRID_START_Y + (row * CELL_HEIGHT);
-      state->state[row][col].size = 1;
-      state->state[row][col].animated_last_frame_by_boid0 = 0;
-      state->state[row][col].animated_last_frame_by_boid1 = 0;
-      state->state[row][col].is_bad_number = (random_number1 & 0xF) > 14;
-      if (state->state[row][col].is_bad_number) {
-        state->total_bad_numbers++;
-      }
-      state->state[row][col].bad_number.bin_id = random_number2 % 4;
+      uint32_t random_number1 = rng_next(rng);
+      uint32_t random_number2 = rng_next(rng);
+      num->bits = 0;
+      num->dx = 0;
+      num->dy = 0;
+      num_set_digit(num, random_number1 % 10);
+      set_bad(state, row * cols + col, (random_number1 & 0xF) > 14);
+      num_set_bin(num, random_number2 % 4);
     }
   }
 
-  spawn_boid(&state->boids[0], 0);
-  spawn_boid(&state->boids[1], 1);
+  spawn_boid(&state->boids[0], 0, rng);
+  spawn_boid(&state->boids[1], 1, rng);
 
   for (int i = 0; i < 5; i++) {
     state->box_anims[i].current_anim_height = 0;
@@ -58,6 +236,36 @@ void game_state_init(GameState *state, int seed) {
   state->play_state = START_SCREEN;
 }
 
+// One simulation tick: regenerate refined numbers and reset last frame's
+// animated cells, move the boids, then mark the numbers they collide with
+void game_state_update(GameState *state) {
+  game_state_refresh_cells(state);
+  update_boids(state);
+  check_collisions_and_animate(state);
+}
+
+// Grow the progress bar after a refinement
+void game_state_update_progress(GameState *state) {
+  ProgressBarAnimation *progress_bar = &state->progress_bar;
+
+  switch (progress_bar->anim_state) {
+  case ANIMATION_IDLE:
+    break;
+  case ANIMATION_GROWING: {
+    int bad_numbers =
+        state->total_bad_numbers == 0 ? 1 : state->total_bad_numbers;
+    int new_progress = (100 - progress_bar->current_progress) / bad_numbers;
+    progress_bar->current_progress += new_progress;
+    if (progress_bar->current_progress >= 100) {
+      progress_bar->current_progress = 100;
+      state->play_state = GAME_WON;
+    }
+    progress_bar->anim_state = ANIMATION_IDLE;
+    break;
+  }
+  }
+}
+
 void game_state_update_boxes(Box *state, int x, int y, int w, int h,
                              int percentage) {
   state->x = x;
@@ -73,13 +281,13 @@ void game_state_draw(GameState *state) {
   // function So this is just a placeholder
 }
 
-void spawn_boid(Boid *boid, int group_id) {
+void spawn_boid(Boid *boid, int group_id, Rng *rng) {
   // Start in center of screen
   boid->x = int2fix15(320);
   boid->y = int2fix15(240);
 
-  boid->vx = ((rand() & 0xFFFF) * 3) - int2fix15(3);
-  boid->vy = ((rand() & 0xFFFF) * 3) - int2fix15(3);
+  boid->vx = ((rng_next(rng) & 0xFFFF) * 3) - int2fix15(3);
+  boid->vy = ((rng_next(rng) & 0xFFFF) * 3) - int2fix15(3);
 
   // Assign scout group and initial bias
   boid->scout_group = group_id;
@@ -91,6 +299,7 @@ void spawn_boid(Boid *boid, int group_id) {
 }
 
 void update_boids(GameState *state) {
+  Rng *rng = game_rng(state);
   for (int i = 0; i < NUM_BOIDS; i++) {
 
     // Zero all accumulators variables
@@ -239,8 +448,8 @@ void update_boids(GameState *state) {
       // Avoid division by zero or very small numbers if speed is close to zero
       if (speed == 0) {
         // Give it a small random velocity if speed is exactly zero
-        state->boids[i].vx = ((rand() & 0xFFFF) * 3) - int2fix15(3);
-        state->boids[i].vy = ((rand() & 0xFFFF) * 3) - int2fix15(3);
+        state->boids[i].vx = ((rng_next(rng) & 0xFFFF) * 3) - int2fix15(3);
+        state->boids[i].vy = ((rng_next(rng) & 0xFFFF) * 3) - int2fix15(3);
         speed = MIN_SPEED; // Set speed to min speed to normalize
       }
       state->boids[i].vx =
@@ -256,23 +465,42 @@ void update_boids(GameState *state) {
 }
 
 // Helper function for animation of numbers.
-void animate_numbers(Number *num, fix15 dx, fix15 dy, fix15 threshold_x,
-                     fix15 threshold_y) {
+// jitter is one random word: the low half picks the x shift, the high half
+// the y shift
+void animate_numbers(Number *num, uint32_t jitter) {
   // Calculate the distance to move based on the collision
-  fix15 shift_x = ((rand() & 0xFFFF) * 3) - int2fix15(3);
-  fix15 shift_y = ((rand() & 0xFFFF) * 3) - int2fix15(3);
-
-  // Update the number's position
-  num->x += fix2int15(shift_x);
-  num->y += fix2int15(shift_y);
-  if (num->is_bad_number) {
-    num->size = 2; // Increase size for bad numbers
-  } else {
-    num->size = 1; // Reset size for good numbers
+  fix15 shift_x = ((jitter & 0xFFFF) * 3) - int2fix15(3);
+  fix15 shift_y = ((jitter >> 16) * 3) - int2fix15(3);
+
+  // Update the number's position (its size follows from the touched flag)
+  num->dx += fix2int15(shift_x);
+  num->dy += fix2int15(shift_y);
+}
+
+// Collided cells are animated in batches so the jitter for a whole batch
+// comes from one rng_fill call
+#define JITTER_BATCH 32
+
+static void animate_batch(GameState *state, const uint16_t *cells, int count) {
+  uint32_t jitter[JITTER_BATCH];
+  rng_fill(game_rng(state), jitter, count);
+  for (int i = 0; i < count; i++) {
+    animate_numbers(&state->cells[cells[i]], jitter[i]);
   }
 }
 
-void check_collisions_and_animate(GameState *state) {
+// Collision detection only reads the grid and the boids, so it runs in
+// row bands on the task pool. Each band writes the cells it hit into its
+// own rows' slots; applying the hits is left to one core, in row order,
+// so the result (and the rng sequence) is the same as a serial pass.
+static uint16_t row_hit_count[GRID_MAX_CELLS];
+static uint8_t hit_boid[GRID_MAX_CELLS]; // by cell, valid for counted hits
+static uint16_t hit_cell[GRID_MAX_CELLS];
+
+#define COLLIDE_CELLS_PER_TASK 64
+
+static void collide_rows(void *arg, int row_begin, int row_end) {
+  GameState *state = arg;
 
   fix15 cell_width = int2fix15(CELL_WIDTH);
   fix15 cell_height = int2fix15(CELL_HEIGHT);
@@ -280,12 +508,15 @@ void check_collisions_and_animate(GameState *state) {
   fix15 half_cell_height = divfix(cell_height, int2fix15(2));
   fix15 boid_radius_fix = int2fix15(BOID_COLLISION_RADIUS);
 
-  for (int i = 0; i < ROWS; i++) {
-    for (int j = 0; j < COLS; j++) {
+  for (int i = row_begin; i < row_end; i++) {
+    uint16_t *hits = &hit_cell[i * state->cols];
+    int hit_count = 0;
+    for (int j = 0; j < state->cols; j++) {
+      Number *num = game_cell(state, i, j);
 
       // Calculate cell center coordinates (fixed point)
-      fix15 cell_center_x = int2fix15(state->state[i][j].x) + half_cell_width;
-      fix15 cell_center_y = int2fix15(state->state[i][j].y) + half_cell_height;
+      fix15 cell_center_x = int2fix15(num_x(num, j)) + half_cell_width;
+      fix15 cell_center_y = int2fix15(num_y(num, i)) + half_cell_height;
 
       // Check collision with each boid
       for (int k = 0; k < NUM_BOIDS; k++) {
@@ -301,21 +532,110 @@ void check_collisions_and_animate(GameState *state) {
         fix15 threshold_y = half_cell_height + boid_radius_fix;
 
         if ((abs_dx < threshold_x) && (abs_dy < threshold_y)) {
-          // Collision detected! Animate the number
-          animate_numbers(&state->state[i][j], dx, dy, threshold_x,
-                          threshold_y);
-
-          // Set the appropriate animation flag based on which boid collided
-          if (k == 0) {
-            state->state[i][j].animated_last_frame_by_boid0 = 1;
-          } else if (k == 1) {
-            state->state[i][j].animated_last_frame_by_boid1 = 1;
-          }
+          // Collision detected! Remember which boid it was
+          hits[hit_count++] = i * state->cols + j;
+          hit_boid[i * state->cols + j] = k;
           break;
         }
       }
     }
+    row_hit_count[i] = hit_count;
+  }
+}
+
+void check_collisions_and_animate(GameState *state) {
+  uint16_t batch[JITTER_BATCH];
+  int batch_count = 0;
+
+  int rows_per_task = COLLIDE_CELLS_PER_TASK / state->cols;
+  task_pool_run(collide_rows, state, state->rows,
+                rows_per_task > 0 ? rows_per_task : 1);
+
+  for (int i = 0; i < state->rows; i++) {
+    const uint16_t *hits = &hit_cell[i * state->cols];
+    for (int h = 0; h < row_hit_count[i]; h++) {
+      int cell = hits[h];
+      // Queue the number for animation
+      batch[batch_count++] = cell;
+      if (batch_count == JITTER_BATCH) {
+        animate_batch(state, batch, batch_count);
+        batch_count = 0;
+      }
+
+      // Set the appropriate animation flag based on which boid collided
+      mark_touched(state, cell, hit_boid[cell]);
+    }
+  }
+  animate_batch(state, batch, batch_count);
+}
+
+// Rebuild every group from the bad bitset. The groups are kept up to date
+// as numbers change, so this is only needed to recover from outside edits.
+void group_bad_numbers(GameState *state) {
+  BadGroups *groups = &state->groups;
+  int cells = state->rows * state->cols;
+
+  groups->group_count = 0;
+  for (int i = 0; i < cells; i++) {
+    group_make_single(groups, i);
+    if (bit_test(state->index.bad, i)) {
+      groups->group_count++;
+    }
+  }
+  for (int i = 0; i < cells; i++) {
+    if (bit_test(state->index.bad, i)) {
+      group_join_neighbours(state, i);
+    }
+  }
+}
+
+// Refine every bad number in the group containing idx, in time proportional
+// to the group's size. Returns how many numbers were refined.
+int refine_bad_group(GameState *state, int idx) {
+  BadGroups *groups = &state->groups;
+  static uint16_t members[GRID_MAX_CELLS];
+  int count = 0;
+
+  if (!bit_test(state->index.bad, idx)) {
+    return 0;
+  }
+
+  // Break the group up first so each refinement is a singleton removal
+  int m = idx;
+  do {
+    members[count++] = m;
+    m = groups->next[m];
+  } while (m != idx);
+  for (int i = 0; i < count; i++) {
+    group_make_single(groups, members[i]);
   }
+  groups->group_count += count - 1;
+
+  for (int i = 0; i < count; i++) {
+    num_set_digit(&state->cells[members[i]], 0);
+    refine_cell(state, members[i]);
+  }
+  return count;
+}
+
+// Move the cursor by whole cells, staying inside the part of the grid that
+// is drawn on screen
+void game_state_move_cursor(GameState *state, int dcol, int drow) {
+  int rows = state->rows < ROWS ? state->rows : ROWS;
+  int cols = state->cols < COLS ? state->cols : COLS;
+  int max_x = GRID_START_X + (cols * CELL_WIDTH);
+  int max_y = GRID_START_Y + (rows * CELL_HEIGHT);
+
+  state->cursor.x += dcol * CELL_WIDTH;
+  if (state->cursor.x > max_x)
+    state->cursor.x = max_x;
+  if (state->cursor.x < GRID_START_X)
+    state->cursor.x = GRID_START_X;
+  state->cursor.y += drow * CELL_HEIGHT;
+  if (state->cursor.y > max_y)
+    state->cursor.y = max_y;
+  if (state->cursor.y < GRID_START_Y)
+    state->cursor.y = GRID_START_Y;
 }
 
 void handle_cursor_refinement(GameState *state) {
@@ -324,33 +644,31 @@ void handle_cursor_refinement(GameState *state) {
   int grid_col = (state->cursor.x - GRID_START_X) / CELL_WIDTH;
 
   // Bounds checking
-  if (!is_valid(grid_row, grid_col)) {
+  if (!is_valid(state, grid_row, grid_col)) {
     return;
   }
-  Number *num = &state->state[grid_row][grid_col];
-  if (num->is_bad_number && num->animated_last_frame_by_boid0 == 1) {
-    int bin_id =
-        num->bad_number.bin_id; // Store the bin_id before changing the number
-    num->number = 0;
-    num->refined_last_frame = 1;
-    state->total_bad_numbers--; // Decrement total bad numbers for boid0 case
+  int cell = grid_row * state->cols + grid_col;
+  Number *num = &state->cells[cell];
+  GridIndex *index = &state->index;
+  if (num_is_bad(num) && num_touched_by(num, 0)) {
+    int bin_id = num_bin(num); // Store the bin_id before changing the number
+    num_set_digit(num, 0);
+    refine_cell(state, cell);
     // trigger the animation of the bin
     state->box_anims[bin_id].anim_state = ANIM_GROWING;
     state->progress_bar.anim_state = ANIMATION_GROWING;
 
-    for (int i = 0; i < ROWS; i++) {
-      for (int j = 0; j < COLS; j++) {
-        if (state->state[i][j].animated_last_frame_by_boid0 == 1) {
-          state->state[i][j].refined_last_frame = 1;
-        }
+    // Only cells touched this frame can be refined along with it
+    for (int i = 0; i < index->touched_count; i++) {
+      if (num_touched_by(&state->cells[index->touched_list[i]], 0)) {
+        refine_cell(state, index->touched_list[i]);
       }
     }
-  } else if (num->is_bad_number && num->animated_last_frame_by_boid1 == 1) {
-    int bin_id = num->bad_number.bin_id;
-    int value = num->number;
-    num->number = 0;
-    num->refined_last_frame = 1;
-    state->total_bad_numbers--;
+  } else if (num_is_bad(num) && num_touched_by(num, 1)) {
+    int bin_id = num_bin(num);
+    int value = num_digit(num);
+    num_set_digit(num, 0);
+    refine_cell(state, cell);
     // trigger the animation of the bin
     state->box_anims[bin_id].woe_percentage += value;
     state->box_anims[bin_id].frolic_percentage += value;
@@ -359,12 +677,44 @@ void handle_cursor_refinement(GameState *state) {
 
     state->box_anims[bin_id].anim_state = ANIM_GROWING;
     state->progress_bar.anim_state = ANIMATION_GROWING;
-    for (int i = 0; i < ROWS; i++) {
-      for (int j = 0; j < COLS; j++) {
-        if (state->state[i][j].animated_last_frame_by_boid1 == 1) {
-          state->state[i][j].refined_last_frame = 1;
-        }
+    for (int i = 0; i < index->touched_count; i++) {
+      if (num_touched_by(&state->cells[index->touched_list[i]], 1)) {
+        refine_cell(state, index->touched_list[i]);
       }
     }
   }
+  mark_dirty(state, cell);
+}
+
+// Start-of-frame pass: give refined cells a new number and move everything
+// a boid touched last frame back to its home position. Refined cells are
+// queued on the touched list too, so only that list is visited.
+void game_state_refresh_cells(GameState *state) {
+  GridIndex *index = &state->index;
+
+  for (int i = 0; i < index->touched_count; i++) {
+    int idx = index->touched_list[i];
+    Number *num = &state->cells[idx];
+
+    if (num_is_refined(num)) {
+      uint32_t random_number = rng_next(game_rng(state));
+      num_set_digit(num, random_number % 10);
+      set_bad(state, idx, (random_number & 0xF) > 14);
+      num_set_bin(num, random_number % 4);
+    }
+
+    num_reset_frame(num);
+    bit_clear(index->touched, idx);
+    mark_dirty(state, idx);
+  }
+  index->touched_count = 0;
+}
+
+// Called by the renderer once it has looked at every dirty cell
+void grid_clear_dirty(GameState *state) {
+  GridIndex *index = &state->index;
+  for (int i = 0; i < index->dirty_count; i++) {
+    bit_clear(index->dirty, index->dirty_list[i]);
+  }
+  index->dirty_count = 0;
 }
\ No newline at end of file
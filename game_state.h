@@ -1,13 +1,25 @@
 #include "pico/divider.h"
 #include "pico/multicore.h"
 #include "pico/stdlib.h"
+#include "rng.h"
 
 #ifndef GAME_STATE_H
 #define GAME_STATE_H
 
+// Default grid size; the screen layout is designed around it
 #define ROWS 7
 #define COLS 15
 
+// Capacity of the static cell arena; any rows x cols grid up to this many
+// cells can be chosen at runtime
+#ifndef GRID_MAX_CELLS
+#define GRID_MAX_CELLS 1024
+#endif
+
+// The game advances one tick every FRAMES_PER_TICK VGA refreshes (66.7 ms
+// at 60 Hz); a tick is VGA_FRAME_US * FRAMES_PER_TICK long
+#define FRAMES_PER_TICK 4
+
 #define NUM_BOIDS 2
 
 // === the fixed point macros ========================================
@@ -50,7 +62,7 @@ typedef signed int fix15;
 #define MAX_PIXEL_SHIFT int2fix15(10)
 
 // Define a maximum possible number of bad groups
-#define MAX_BAD_GROUPS (ROWS * COLS)
+#define MAX_BAD_GROUPS GRID_MAX_CELLS
 
 // Numbers within this radius of the boid are considered surrounding the boid
 #define BOID_COLLISION_RADIUS 40
@@ -112,22 +124,24 @@ typedef struct {
   int scout_group; // 0: group 1, 1: group 2
 } Boid;
 
+// A grid cell packed into 4 bytes. The digit, bin id and per-frame flags
+// share one bit field; dx/dy are the jitter offset from the cell's home
+// position in the grid. Use the num_* accessors below.
 typedef struct {
-  int bin_id;
-} BadNumber;
-
-typedef struct {
-  int x;
-  int y;
-  int number;
-  int size;
-  int animated_last_frame_by_boid0;
-  int animated_last_frame_by_boid1;
-  int refined_last_frame;
-  bool is_bad_number;
-  BadNumber bad_number;
+  uint16_t bits;
+  int8_t dx;
+  int8_t dy;
 } Number;
 
+#define NUM_DIGIT_MASK 0x000F
+#define NUM_BIN_SHIFT 4
+#define NUM_BIN_MASK (0x3 << NUM_BIN_SHIFT)
+#define NUM_BAD (1 << 6)
+#define NUM_TOUCHED_BOID0 (1 << 7) // animated by boid 0 this frame
+#define NUM_TOUCHED_BOID1 (1 << 8) // animated by boid 1 this frame
+#define NUM_REFINED (1 << 9)       // refined, regenerate next frame
+#define NUM_TOUCHED (NUM_TOUCHED_BOID0 | NUM_TOUCHED_BOID1)
+
 typedef struct {
   int x;
   int y;
@@ -137,28 +151,124 @@ typedef struct {
 
 typedef enum { START_SCREEN, PLAYING, GAME_WON } PlayState;
 
+#define GRID_WORDS ((GRID_MAX_CELLS + 31) / 32)
+
+// Incrementally maintained views of the grid, so per-frame work scales with
+// the cells that changed instead of rows * cols. Cells are flat indices.
+typedef struct {
+  uint32_t bad[GRID_WORDS];     // cells holding a bad number
+  uint32_t touched[GRID_WORDS]; // cells a boid animated this frame
+  uint16_t touched_list[GRID_MAX_CELLS];
+  int touched_count;
+  uint32_t dirty[GRID_WORDS]; // cells to look at on the next draw
+  uint16_t dirty_list[GRID_MAX_CELLS];
+  int dirty_count;
+} GridIndex;
+
+// 4-connected clusters of bad numbers as a union-find forest. Each group's
+// members also form a circular list through next[], so a whole group can be
+// visited (or split again) in time proportional to its size.
+typedef struct {
+  uint16_t parent[GRID_MAX_CELLS];
+  uint16_t size[GRID_MAX_CELLS]; // valid at roots
+  uint16_t next[GRID_MAX_CELLS];
+  int group_count; // number of groups of bad numbers
+} BadGroups;
+
 typedef struct {
-  Number state[ROWS][COLS];
+  int rows;
+  int cols;
+  Number *cells; // rows * cols cells, row-major, from the static arena
+  GridIndex index;
+  BadGroups groups;
   Box boxes[5];
   Boid boids[NUM_BOIDS];
   BoxAnim box_anims[5];
   Cursor cursor;
   PlayState play_state;
-  int total_bad_numbers;
+  int total_bad_numbers; // kept equal to the number of bits in index.bad
   ProgressBarAnimation progress_bar;
+  Rng rng[2]; // one generator per core
 } GameState;
 
+// The calling core's random number generator
+static inline Rng *game_rng(GameState *state) {
+  return &state->rng[get_core_num()];
+}
+
+// Cell at (row, col); no bounds checking
+static inline Number *game_cell(GameState *state, int row, int col) {
+  return &state->cells[row * state->cols + col];
+}
+
+// === Number accessors ===
+static inline int num_digit(const Number *num) {
+  return num->bits & NUM_DIGIT_MASK;
+}
+static inline void num_set_digit(Number *num, int digit) {
+  num->bits = (num->bits & ~NUM_DIGIT_MASK) | (digit & NUM_DIGIT_MASK);
+}
+static inline int num_bin(const Number *num) {
+  return (num->bits & NUM_BIN_MASK) >> NUM_BIN_SHIFT;
+}
+static inline void num_set_bin(Number *num, int bin_id) {
+  num->bits =
+      (num->bits & ~NUM_BIN_MASK) | ((bin_id << NUM_BIN_SHIFT) & NUM_BIN_MASK);
+}
+static inline bool num_is_bad(const Number *num) {
+  return (num->bits & NUM_BAD) != 0;
+}
+static inline void num_set_bad(Number *num, bool bad) {
+  num->bits = bad ? (num->bits | NUM_BAD) : (num->bits & ~NUM_BAD);
+}
+static inline bool num_touched_by(const Number *num, int boid) {
+  return (num->bits & (boid == 0 ? NUM_TOUCHED_BOID0 : NUM_TOUCHED_BOID1)) != 0;
+}
+static inline void num_set_touched(Number *num, int boid) {
+  num->bits |= (boid == 0 ? NUM_TOUCHED_BOID0 : NUM_TOUCHED_BOID1);
+}
+static inline bool num_is_refined(const Number *num) {
+  return (num->bits & NUM_REFINED) != 0;
+}
+static inline void num_set_refined(Number *num) { num->bits |= NUM_REFINED; }
+
+// Bad numbers grow while a boid is stirring them up
+static inline int num_size(const Number *num) {
+  return ((num->bits & NUM_BAD) && (num->bits & NUM_TOUCHED)) ? 2 : 1;
+}
+
+// Top-left corner of the cell, including its jitter offset
+static inline int num_x(const Number *num, int col) {
+  return GRID_START_X + (col * CELL_WIDTH) + num->dx;
+}
+static inline int num_y(const Number *num, int row) {
+  return GRID_START_Y + (row * CELL_HEIGHT) + num->dy;
+}
+
+// Back to the home position with this frame's flags cleared
+static inline void num_reset_frame(Number *num) {
+  num->bits &= ~(NUM_TOUCHED | NUM_REFINED);
+  num->dx = 0;
+  num->dy = 0;
+}
+
 // Function declarations
-void game_state_init(GameState *state, int seed);
+void game_state_init(GameState *state, int rows, int cols, int seed);
 void game_state_update(GameState *state);
+void game_state_update_progress(GameState *state);
 void game_state_draw(GameState *state);
 void game_state_update_boxes(Box *state, int x, int y, int w, int h,
                              int percentage);
-void spawn_boid(Boid *boid, int group_id);
+void spawn_boid(Boid *boid, int group_id, Rng *rng);
 void update_boids(GameState *state);
 void check_collisions_and_animate(GameState *state);
-void animate_numbers(Number *num, fix15 dx, fix15 dy, fix15 shift_x,
-                     fix15 shift_y);
+void animate_numbers(Number *num, uint32_t jitter);
 void group_bad_numbers(GameState *state);
+int bad_group_find(GameState *state, int idx);
+int bad_group_size(GameState *state, int idx);
+int refine_bad_group(GameState *state, int idx);
+void game_state_move_cursor(GameState *state, int dcol, int drow);
 void handle_cursor_refinement(GameState *state);
+void game_state_refresh_cells(GameState *state);
+void grid_clear_dirty(GameState *state);
 #endif // GAME_STATE_H
\ No newline at end of file
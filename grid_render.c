@@ -0,0 +1,233 @@
+#include "grid_render.h"
+#include "sprite.h"
+#include "vga16_graphics.h"
+
+// ==================================================
+// === grid renderer -- only touches cells whose visible state changed
+// ==================================================
+typedef struct {
+  signed char digit; // -1 if nothing has been drawn in this cell
+  signed char color;
+  signed char size;
+  short x; // top-left corner of the drawn glyph
+  short y;
+} DrawnCell;
+
+static DrawnCell drawn_grid[GRID_MAX_CELLS];
+static bool grid_redraw_all;
+
+// ==================================================
+// === sprites -- the boids and the cursor, over the grid
+// ==================================================
+#define BOID_SIZE (2 * BOID_RADIUS)
+
+static uint8_t boid_pixels[2][BOID_SIZE * (BOID_SIZE + 1) / 2];
+static uint8_t cursor_pixels[CELL_HEIGHT * (CELL_WIDTH + 1) / 2];
+static SpriteImage boid_images[2];
+static SpriteImage cursor_image;
+static int boid_sprites[NUM_BOIDS];
+static int cursor_sprite;
+static bool sprites_ready;
+
+static void image_set(uint8_t *pixels, int w, int x, int y, int color) {
+  uint8_t *byte = &pixels[y * ((w + 1) / 2) + x / 2];
+  *byte = x & 1 ? (*byte & 0x0f) | (color << 4) : (*byte & 0xf0) | color;
+}
+
+// Boids are discs in their scout group's color; the cursor is the outline
+// of a cell. BLACK is transparent in both.
+static void init_sprites(GameState *state) {
+  static const int boid_colors[2] = {MAGENTA, ORANGE};
+  for (int g = 0; g < 2; g++) {
+    for (int y = 0; y < BOID_SIZE; y++) {
+      for (int x = 0; x < BOID_SIZE; x++) {
+        int dx = 2 * x + 1 - BOID_SIZE;
+        int dy = 2 * y + 1 - BOID_SIZE;
+        bool inside = dx * dx + dy * dy <= BOID_SIZE * BOID_SIZE;
+        image_set(boid_pixels[g], BOID_SIZE, x, y,
+                  inside ? boid_colors[g] : BLACK);
+      }
+    }
+    boid_images[g] = (SpriteImage){BOID_SIZE, BOID_SIZE, BLACK, boid_pixels[g]};
+  }
+  for (int y = 0; y < CELL_HEIGHT; y++) {
+    for (int x = 0; x < CELL_WIDTH; x++) {
+      bool edge = x == 0 || y == 0 || x == CELL_WIDTH - 1 ||
+                  y == CELL_HEIGHT - 1;
+      image_set(cursor_pixels, CELL_WIDTH, x, y, edge ? CYAN : BLACK);
+    }
+  }
+  cursor_image = (SpriteImage){CELL_WIDTH, CELL_HEIGHT, BLACK, cursor_pixels};
+
+  sprite_layer_reset();
+  for (int i = 0; i < NUM_BOIDS; i++) {
+    boid_sprites[i] =
+        sprite_add(&boid_images[state->boids[i].scout_group ? 1 : 0], 0);
+  }
+  cursor_sprite = sprite_add(&cursor_image, 1);
+  sprites_ready = true;
+}
+
+static void place_sprites(GameState *state) {
+  for (int i = 0; i < NUM_BOIDS; i++) {
+    if (boid_sprites[i] >= 0) {
+      Boid *boid = &state->boids[i];
+      sprite_move(boid_sprites[i], fix2int15(boid->x) - BOID_RADIUS,
+                  fix2int15(boid->y) - BOID_RADIUS);
+      sprite_set_visible(boid_sprites[i], true);
+    }
+  }
+  if (cursor_sprite >= 0) {
+    sprite_move(cursor_sprite, state->cursor.x, state->cursor.y);
+    sprite_set_visible(cursor_sprite, true);
+  }
+}
+
+// Forget what was drawn, e.g. after the screen has been cleared
+void invalidate_grid(void) {
+  for (int i = 0; i < GRID_MAX_CELLS; i++) {
+    drawn_grid[i].digit = -1;
+  }
+  grid_redraw_all = true;
+  sprite_layer_invalidate();
+}
+
+// What a cell should look like this frame (text centered in cell)
+static DrawnCell cell_target(GameState *state, int row, int col) {
+  Number *num = game_cell(state, row, col);
+  DrawnCell want = {num_digit(num), num_is_bad(num) ? RED : WHITE,
+                    num_size(num), num_x(num, col) + CELL_WIDTH / 2,
+                    num_y(num, row) + CELL_HEIGHT / 2};
+  return want;
+}
+
+static bool cell_matches(const DrawnCell *drawn, const DrawnCell *want) {
+  return drawn->digit == want->digit && drawn->color == want->color &&
+         drawn->size == want->size && drawn->x == want->x &&
+         drawn->y == want->y;
+}
+
+// Bring one cell on screen up to date with the game state. Runs from the
+// VGA draw queue, so the state may have moved on since it was queued.
+static void paint_grid_cell(void *arg, int cell) {
+  static char num_str[2] = {0, 0};
+  GameState *state = arg;
+  int row = cell >> 16;
+  int col = cell & 0xffff;
+
+  // The grid may have been re-initialised smaller in the meantime
+  if (row >= state->rows || col >= state->cols) {
+    return;
+  }
+  DrawnCell *drawn = &drawn_grid[row * state->cols + col];
+  DrawnCell want = cell_target(state, row, col);
+
+  if (cell_matches(drawn, &want)) {
+    return;
+  }
+
+  // Erase the old glyph (text is drawn with a transparent background)
+  if (drawn->digit >= 0) {
+    fillRect(drawn->x, drawn->y, 6 * drawn->size, 8 * drawn->size, BLACK);
+  }
+
+  num_str[0] = '0' + want.digit;
+  setCursor(want.x, want.y);
+  setTextColor(want.color);
+  setTextSize(want.size);
+  writeString(num_str);
+
+  *drawn = want;
+}
+
+// A whole row of the visible window, for a full redraw
+static void paint_grid_row(void *arg, int row) {
+  GameState *state = arg;
+  int cols = state->cols < COLS ? state->cols : COLS;
+  for (int col = 0; col < cols; col++) {
+    paint_grid_cell(state, (row << 16) | col);
+  }
+}
+
+// Widen [y0, y1) by the lines of a cell's old and new glyph if its visible
+// state changed. Returns whether it did.
+static bool cell_lines(GameState *state, int row, int col, short *y0,
+                       short *y1) {
+  DrawnCell *drawn = &drawn_grid[row * state->cols + col];
+  DrawnCell want = cell_target(state, row, col);
+
+  if (cell_matches(drawn, &want)) {
+    return false;
+  }
+  if (want.y < *y0) {
+    *y0 = want.y;
+  }
+  if (want.y + 8 * want.size > *y1) {
+    *y1 = want.y + 8 * want.size;
+  }
+  if (drawn->digit >= 0) {
+    if (drawn->y < *y0) {
+      *y0 = drawn->y;
+    }
+    if (drawn->y + 8 * drawn->size > *y1) {
+      *y1 = drawn->y + 8 * drawn->size;
+    }
+  }
+  return true;
+}
+
+// Queue a cell whose visible state changed, over the lines of both its old
+// and new glyph, so it is redrawn behind the raster
+static void draw_grid_cell(GameState *state, int row, int col) {
+  short y0 = VGA_HEIGHT, y1 = 0;
+  if (cell_lines(state, row, col, &y0, &y1)) {
+    vga_draw_defer(y0, y1 - y0, paint_grid_cell, state, (row << 16) | col);
+  }
+}
+
+// Queue a full row as one draw over the lines of all its changed cells.
+// A full redraw queued cell by cell would overflow the draw queue, which
+// then paints everything at once wherever the beam is.
+static void draw_grid_row(GameState *state, int row, int cols) {
+  short y0 = VGA_HEIGHT, y1 = 0;
+  bool changed = false;
+  for (int col = 0; col < cols; col++) {
+    changed |= cell_lines(state, row, col, &y0, &y1);
+  }
+  if (changed) {
+    vga_draw_defer(y0, y1 - y0, paint_grid_row, state, row);
+  }
+}
+
+// Only the top-left ROWS x COLS window of a larger grid fits the layout.
+// Normally just the cells the game state marked dirty are looked at.
+void draw_grid(GameState *state) {
+  int rows = state->rows < ROWS ? state->rows : ROWS;
+  int cols = state->cols < COLS ? state->cols : COLS;
+
+  if (!sprites_ready) {
+    init_sprites(state);
+  }
+  // Cells are painted with the sprites off the screen
+  sprite_layer_hide();
+
+  if (grid_redraw_all) {
+    for (int row = 0; row < rows; row++) {
+      draw_grid_row(state, row, cols);
+    }
+    grid_redraw_all = false;
+  } else {
+    GridIndex *index = &state->index;
+    for (int i = 0; i < index->dirty_count; i++) {
+      int row = index->dirty_list[i] / state->cols;
+      int col = index->dirty_list[i] % state->cols;
+      if (row < rows && col < cols) {
+        draw_grid_cell(state, row, col);
+      }
+    }
+  }
+  grid_clear_dirty(state);
+
+  place_sprites(state);
+  sprite_layer_show();
+}
@@ -0,0 +1,11 @@
+#include "game_state.h"
+
+#ifndef GRID_RENDER_H
+#define GRID_RENDER_H
+
+void invalidate_grid(void);
+// Changed cells, and the boid and cursor sprites over them, go on the VGA
+// draw queue and appear once vga_draw_flush() finds the beam clear of them
+void draw_grid(GameState *state);
+
+#endif // GRID_RENDER_H
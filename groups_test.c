@@ -0,0 +1,259 @@
+/**
+ * Bad number group test (host build only)
+ *
+ * Plays games at a few grid sizes and, after every frame, checks the
+ * union-find groups of bad numbers against a breadth-first labelling of
+ * the bad cells: same group exactly when 4-connected, the right sizes,
+ * member lists that go round each group once, and the group count. Every
+ * few frames a random bad group is refined with refine_bad_group, which
+ * must clear exactly that group, and group_bad_numbers must rebuild the
+ * same partition from scratch. Play rarely makes big groups, so grids are
+ * also filled at random around the percolation density, regrouped with
+ * group_bad_numbers and refined away a group at a time.
+ *
+ * Build with the SDK host platform:
+ *   cmake -S . -B build-host -DPICO_PLATFORM=host && cmake --build build-host
+ *   ctest --test-dir build-host
+ *
+ * Usage: groups_test [frames per game, default 2000]
+ */
+#include "game_state.h"
+#include "task_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static GameState game_state;
+static int label[GRID_MAX_CELLS];      // BFS component, -1 if not bad
+static int label_size[GRID_MAX_CELLS]; // cells per component
+static int failures;
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("  FAIL %s: ", #cond);                                            \
+      printf(__VA_ARGS__);                                                     \
+      printf("\n");                                                            \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static bool is_bad(GameState *state, int idx) {
+  return num_is_bad(&state->cells[idx]);
+}
+
+static bool bit(const uint32_t *bits, int idx) {
+  return bits[idx >> 5] >> (idx & 31) & 1;
+}
+
+// Label the 4-connected components of bad cells; returns how many
+static int label_components(GameState *state) {
+  static int queue[GRID_MAX_CELLS];
+  int cells = state->rows * state->cols;
+  int components = 0;
+  for (int i = 0; i < cells; i++) {
+    label[i] = -1;
+  }
+  for (int i = 0; i < cells; i++) {
+    if (!is_bad(state, i) || label[i] >= 0) {
+      continue;
+    }
+    int head = 0, tail = 0;
+    label[i] = components;
+    queue[tail++] = i;
+    while (head < tail) {
+      int idx = queue[head++];
+      int row = idx / state->cols, col = idx % state->cols;
+      int next[4] = {col > 0 ? idx - 1 : -1,
+                     col < state->cols - 1 ? idx + 1 : -1,
+                     row > 0 ? idx - state->cols : -1,
+                     row < state->rows - 1 ? idx + state->cols : -1};
+      for (int k = 0; k < 4; k++) {
+        if (next[k] >= 0 && is_bad(state, next[k]) && label[next[k]] < 0) {
+          label[next[k]] = components;
+          queue[tail++] = next[k];
+        }
+      }
+    }
+    label_size[components++] = tail;
+  }
+  return components;
+}
+
+static void check_groups(GameState *state, const char *when, int frame) {
+  static int root_of[GRID_MAX_CELLS]; // component -> group root
+  int cells = state->rows * state->cols;
+  int components = label_components(state);
+  int bad = 0;
+
+  CHECK(state->groups.group_count == components,
+        "%s frame %d: %d groups, %d components", when, frame,
+        state->groups.group_count, components);
+  for (int c = 0; c < components; c++) {
+    root_of[c] = -1;
+  }
+  for (int i = 0; i < cells; i++) {
+    CHECK(bit(state->index.bad, i) == is_bad(state, i),
+          "%s frame %d: bad bit of cell %d", when, frame, i);
+    if (label[i] < 0) {
+      continue;
+    }
+    bad++;
+    int root = bad_group_find(state, i);
+    int c = label[i];
+    if (root_of[c] < 0) {
+      root_of[c] = root;
+      CHECK(bad_group_size(state, i) == label_size[c],
+            "%s frame %d: cell %d in a group of %d, component of %d", when,
+            frame, i, bad_group_size(state, i), label_size[c]);
+      // The member list goes round the component once
+      int m = i, count = 0;
+      do {
+        CHECK(label[m] == c, "%s frame %d: cell %d listed with cell %d",
+              when, frame, m, i);
+        m = state->groups.next[m];
+      } while (m != i && ++count <= cells);
+      CHECK(count + 1 == label_size[c],
+            "%s frame %d: list of cell %d has %d members, component %d",
+            when, frame, i, count + 1, label_size[c]);
+    } else {
+      CHECK(root == root_of[c], "%s frame %d: cell %d split from its component",
+            when, frame, i);
+    }
+  }
+  for (int c = 0; c < components; c++) {
+    for (int d = c + 1; d < components; d++) {
+      CHECK(root_of[c] != root_of[d], "%s frame %d: components %d and %d joined",
+            when, frame, c, d);
+    }
+  }
+  CHECK(state->total_bad_numbers == bad, "%s frame %d: %d bad counted, %d seen",
+        when, frame, state->total_bad_numbers, bad);
+}
+
+// Refine the group of a random bad cell and check just that group went
+static int refine_random_group(GameState *state, int frame) {
+  int cells = state->rows * state->cols;
+  int start = rand() % cells;
+  int idx = -1;
+  for (int i = 0; i < cells && idx < 0; i++) {
+    if (is_bad(state, (start + i) % cells)) {
+      idx = (start + i) % cells;
+    }
+  }
+  if (idx < 0) {
+    CHECK(refine_bad_group(state, start) == 0,
+          "refine frame %d: refined a good cell's group", frame);
+    return 0;
+  }
+
+  static bool was_bad[GRID_MAX_CELLS];
+  for (int i = 0; i < cells; i++) {
+    was_bad[i] = is_bad(state, i);
+  }
+  int c = label[idx];
+  int expect = label_size[c];
+  int groups = state->groups.group_count;
+  int total = state->total_bad_numbers;
+  grid_clear_dirty(state);
+
+  int refined = refine_bad_group(state, idx);
+  CHECK(refined == expect, "refine frame %d: %d refined, group of %d", frame,
+        refined, expect);
+  CHECK(state->groups.group_count == groups - 1,
+        "refine frame %d: %d groups left of %d", frame,
+        state->groups.group_count, groups);
+  CHECK(state->total_bad_numbers == total - expect,
+        "refine frame %d: %d bad left of %d", frame, state->total_bad_numbers,
+        total);
+  for (int i = 0; i < cells; i++) {
+    Number *num = &state->cells[i];
+    if (was_bad[i] && label[i] == c) {
+      CHECK(!num_is_bad(num) && num_is_refined(num) &&
+                bit(state->index.dirty, i),
+            "refine frame %d: member %d not refined and redrawn", frame, i);
+    } else {
+      CHECK(num_is_bad(num) == was_bad[i],
+            "refine frame %d: cell %d outside the group changed", frame, i);
+    }
+  }
+  return refined;
+}
+
+static void play(int rows, int cols, int seed, int frames) {
+  int refined = 0, max_group = 0;
+  game_state_init(&game_state, rows, cols, seed);
+  game_state.play_state = PLAYING;
+  check_groups(&game_state, "init", 0);
+
+  for (int frame = 1; frame <= frames; frame++) {
+    game_state_update(&game_state);
+    check_groups(&game_state, "update", frame);
+    for (int c = 0; c < game_state.groups.group_count; c++) {
+      if (label_size[c] > max_group) {
+        max_group = label_size[c];
+      }
+    }
+    if (frame % 5 == 0) {
+      refined += refine_random_group(&game_state, frame);
+      check_groups(&game_state, "refine", frame);
+    }
+    if (frame % 50 == 0) {
+      group_bad_numbers(&game_state);
+      check_groups(&game_state, "rebuild", frame);
+    }
+    grid_clear_dirty(&game_state);
+  }
+  printf("%dx%d seed %d: %d frames, largest group %d, %d refined by group\n",
+         game_state.rows, game_state.cols, seed, frames, max_group, refined);
+}
+
+// Mark cells bad directly, as an outside edit, regroup, then refine the
+// groups away one at a time
+static void fill_and_clear(int rows, int cols, int percent) {
+  int refined = 0, max_group = 0, steps = 0;
+  game_state_init(&game_state, rows, cols, 1);
+  int cells = game_state.rows * game_state.cols;
+  memset(game_state.index.bad, 0, sizeof(game_state.index.bad));
+  game_state.total_bad_numbers = 0;
+  for (int i = 0; i < cells; i++) {
+    bool bad = rand() % 100 < percent;
+    num_set_bad(&game_state.cells[i], bad);
+    if (bad) {
+      game_state.index.bad[i >> 5] |= 1u << (i & 31);
+      game_state.total_bad_numbers++;
+    }
+  }
+  group_bad_numbers(&game_state);
+  check_groups(&game_state, "fill", 0);
+  int total = game_state.total_bad_numbers;
+  for (int c = 0; c < game_state.groups.group_count; c++) {
+    if (label_size[c] > max_group) {
+      max_group = label_size[c];
+    }
+  }
+  while (game_state.total_bad_numbers > 0 && steps < cells) {
+    refined += refine_random_group(&game_state, ++steps);
+    check_groups(&game_state, "clear", steps);
+  }
+  CHECK(refined == total, "fill %dx%d: %d of %d refined", rows, cols, refined,
+        total);
+  printf("%dx%d filled %d%%: %d bad, largest group %d, cleared in %d groups\n",
+         game_state.rows, game_state.cols, percent, total, max_group, steps);
+}
+
+int main(int argc, char **argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 2000;
+  srand(1);
+  task_pool_init();
+  play(ROWS, COLS, 1, frames);
+  play(ROWS, COLS, 7, frames);
+  play(24, 40, 3, frames);
+  play(1, 64, 5, frames);
+  for (int percent = 20; percent <= 80; percent += 20) {
+    fill_and_clear(ROWS, COLS, percent);
+    fill_and_clear(32, 32, percent);
+  }
+  printf("%s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+#include "input.h"
+
+static InputEvent input_log[INPUT_LOG_SIZE];
+static uint32_t log_head;  // events ever written
+static uint32_t log_start; // first event still in the log
+
+// Input state as of the latest sample
+static InputEvent current = {0, 2048, 2048, 1};
+static InputDirection current_direction = INPUT_NONE;
+
+static void log_current(uint32_t t_us) {
+  current.t_us = t_us;
+  input_log[log_head & (INPUT_LOG_SIZE - 1)] = current;
+  log_head++;
+  // Full: the oldest event is overwritten
+  if (log_head - log_start > INPUT_LOG_SIZE) {
+    log_start = log_head - INPUT_LOG_SIZE;
+  }
+}
+
+static InputDirection direction(uint16_t adc_x, uint16_t adc_y) {
+  // X wins over Y, so diagonals move sideways
+  if (adc_x > X_RIGHT_THRESHOLD) {
+    return INPUT_RIGHT;
+  } else if (adc_x < X_LEFT_THRESHOLD) {
+    return INPUT_LEFT;
+  } else if (adc_y > Y_DOWN_THRESHOLD) {
+    return INPUT_DOWN;
+  } else if (adc_y < Y_UP_THRESHOLD) {
+    return INPUT_UP;
+  }
+  return INPUT_NONE;
+}
+
+InputDirection input_joystick(uint16_t adc_x, uint16_t adc_y, uint32_t t_us) {
+  InputDirection dir = direction(adc_x, adc_y);
+  current.adc_x = adc_x;
+  current.adc_y = adc_y;
+  // The readings jitter by a few counts all the time; only a change of
+  // direction is worth an event
+  if (dir != current_direction) {
+    current_direction = dir;
+    log_current(t_us);
+  }
+  return dir;
+}
+
+// Returns true once per debounced press
+bool input_button(Debouncer *debouncer, bool level, uint32_t t_us) {
+  bool pressed = false;
+
+  if (level != current.button) {
+    current.button = level;
+    log_current(t_us);
+  }
+
+  switch (debouncer->state) {
+  case NOT_PRESSED:
+    if (level == 0) {
+      debouncer->possible_press = level;
+      debouncer->state = MAYBE_PRESSED;
+    }
+    break;
+  case MAYBE_PRESSED:
+    if (level == 0 && debouncer->possible_press == 0) {
+      pressed = true;
+      debouncer->state = PRESSED;
+    }
+    break;
+  case PRESSED:
+    if (level == 1)
+      debouncer->state = MAYBE_NOT_PRESSED;
+    break;
+  case MAYBE_NOT_PRESSED:
+    if (level == 0)
+      debouncer->state = PRESSED;
+    else
+      debouncer->state = NOT_PRESSED;
+    break;
+  default:
+    break;
+  }
+  return pressed;
+}
+
+int input_log_count(void) { return log_head - log_start; }
+
+uint32_t input_log_dropped(void) { return log_start; }
+
+const InputEvent *input_log_get(int i) {
+  return &input_log[(log_start + i) & (INPUT_LOG_SIZE - 1)];
+}
+
+void input_log_clear(void) { log_start = log_head = 0; }
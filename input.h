@@ -0,0 +1,60 @@
+#include "pico/stdlib.h"
+
+#ifndef INPUT_H
+#define INPUT_H
+
+// Joystick and button handling, kept apart from the ADC and GPIO reads so
+// the same logic runs on the device and in the host sim runner.
+//
+// Every change of input state (button level, or joystick leaving/entering a
+// direction) is appended to a ring-buffered log. The log can be dumped over
+// serial and replayed by sim_runner to reproduce a real session. Only the
+// latest INPUT_LOG_SIZE events are kept: once a session has logged more,
+// the oldest are dropped (input_log_dropped() counts them), the dump no
+// longer starts with the game, and sim_runner refuses to replay it.
+
+// How often the input threads sample, in microseconds
+#define INPUT_JOYSTICK_PERIOD_US 70000
+#define INPUT_BUTTON_PERIOD_US 30000
+
+// Joystick ADC thresholds (12-bit readings, centre around 2048)
+#define X_RIGHT_THRESHOLD 3000
+#define X_LEFT_THRESHOLD 500
+#define Y_DOWN_THRESHOLD 3000
+#define Y_UP_THRESHOLD 500
+
+#ifndef INPUT_LOG_SIZE
+#define INPUT_LOG_SIZE 512 // events, must be a power of two
+#endif
+
+typedef struct {
+  uint32_t t_us;  // time_us_32() when the change was seen
+  uint16_t adc_x; // raw joystick readings
+  uint16_t adc_y;
+  uint8_t button; // raw GPIO level, 0 = pressed (pulled up)
+} InputEvent;
+
+typedef enum {
+  INPUT_NONE,
+  INPUT_RIGHT,
+  INPUT_LEFT,
+  INPUT_DOWN,
+  INPUT_UP
+} InputDirection;
+
+typedef struct {
+  enum { NOT_PRESSED, MAYBE_PRESSED, PRESSED, MAYBE_NOT_PRESSED } state;
+  int possible_press;
+} Debouncer;
+
+// Feed one sample; both log the sample if it changed the input state
+InputDirection input_joystick(uint16_t adc_x, uint16_t adc_y, uint32_t t_us);
+bool input_button(Debouncer *debouncer, bool level, uint32_t t_us);
+
+// Log access; index 0 is the oldest event still held
+int input_log_count(void);
+uint32_t input_log_dropped(void);
+const InputEvent *input_log_get(int i);
+void input_log_clear(void);
+
+#endif // INPUT_H
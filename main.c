@@ -27,10 +27,19 @@
 // ==========================================
 // === VGA graphics library
 // ==========================================
+#include "boot_screen.h"
+#include "chrome.h"
 #include "game_state.h"
+#include "grid_render.h"
+#include "input.h"
 #include "hardware/dma.h"
 #include "hardware/pio.h"
 #include "pico/stdlib.h"
+#include "rle.h"
+#include "seed.h"
+#include "sprite.h"
+#include "stream.h"
+#include "task_pool.h"
 #include "vga16_graphics.h"
 #include <assert.h> // For assert
 #include <math.h>
@@ -56,98 +65,31 @@
 // protothreads header
 #include "pt_cornell_rp2040_v1_3.h"
 
-#define FRAME_RATE 60000 // 60 FPS
+// The game, progress bar and box animation threads are paced by the VGA
+// frame clock: one tick every FRAMES_PER_TICK refreshes (see game_state.h)
+// Box animations hold fully grown for this many refreshes (3 s)
+#define BOX_HOLD_FRAMES 180
 
 int ADC_GPIO_VX = 28;
 int ADC_GPIO_VY = 27;
 int BUTTON_PIN = 22;
 
-int X_RIGHT_THRESHOLD = 3000;
-int X_LEFT_THRESHOLD = 500;
-
-int Y_DOWN_THRESHOLD = 3000;
-int Y_UP_THRESHOLD = 500;
-int RIGHT_MARGIN_GRID = GRID_START_X + (COLS * CELL_WIDTH);
-int LEFT_MARGIN_GRID = GRID_START_X;
-int TOP_MARGIN_GRID = GRID_START_Y;
-int BOTTOM_MARGIN_GRID = GRID_START_Y + (ROWS * CELL_HEIGHT);
+// Grid size used for the game; anything up to GRID_MAX_CELLS cells
+int GRID_ROWS = ROWS;
+int GRID_COLS = COLS;
 
 GameState game_state;
+// Seed of the current game, reported with the input log for replays
+uint32_t game_seed;
 // semaphore
 static struct pt_sem start_game_sem;
-
-// ==================================================
-// === lumon logo : Pass the center of the logo and dimension (w, h)
-// ==================================================
-void draw_lumon_logo(int cx, int cy, int logo_w, int logo_h) {
-  char fill_color = DARK_BLUE; // Dark blue for the globe fill
-  char line_color = WHITE; // Bright white for outlines and text
-
-  // Calculate radii for the ovals
-  short outer_rx = logo_w / 2;
-  short ry = logo_h / 2; //
-  short middle_rx = (short)(outer_rx * 0.75);
-  short inner_rx = (short)(outer_rx * 0.5);
-
-  drawOval(cx, cy, outer_rx, ry, line_color);  // Outer oval
-  drawOval(cx, cy, middle_rx, ry, line_color); // Middle oval
-  drawOval(cx, cy, inner_rx, ry, line_color);  // Inner oval
-
-  drawHLine(cx - middle_rx, cy - (ry - 5), logo_w * 0.75, line_color);
-  drawHLine(cx - middle_rx, cy + (ry - 5), logo_w * 0.75, line_color);
-
-  char text_str[] = "LUMON";
-  setCursor(cx - (middle_rx + 2), cy - 5);
-  setTextSize(2);
-  setTextColor(WHITE);
-  writeString(text_str);
-}
-
-void draw_boxes(int x, int y, int w, int h, int percentage, int idx) {
-
-  // Top Rect (Index Display)
-  char index[3] = {0, 0, 0}; // Increased size for two digits + null terminator
-  // Format the index as a two-digit string (e.g., 00, 01, 02, 03)
-  index[0] = '0'; // Always start with '0'
-  index[1] = '0' + idx;
-  drawRect(x, y, w, h, CYAN);
-  setCursor(x + (w / 2) - 4,
-            y + (h / 2) - 4); // Adjust cursor slightly for two digits
-  setTextSize(1);
-  setTextColor(WHITE);
-  writeString(index);
-
-  // Bottom Rect (Progress Bar)
-  int bottom_y = y + h + 2;
-  // Draw the background/outline of the progress bar
-  drawRect(x, bottom_y, w, h, CYAN); // Outline is CYAN
-
-  int fill_w = (w * percentage) / 100;
-  // Ensure fill width doesn't exceed total width
-  if (fill_w > w) {
-    fill_w = w;
-  }
-  if (fill_w < 0) {
-    fill_w = 0;
-  }
-
-  // Draw the filled portion representing the percentage
-  if (fill_w > 0) {
-    fillRect(x, bottom_y, fill_w, h, WHITE); // Fill is WHITE
-  }
-
-  // Draw the percentage text
-  char percent_str[5]; // Buffer for percentage string (e.g., "100%")
-  sprintf(percent_str, "%d%%", percentage); // Format the percentage
-  int text_width = strlen(percent_str) * 6; // Assuming font width of 6 pixels
-  int text_x = x + 5;
-  int text_y = bottom_y + (h / 2) - 4; // Adjust vertical position
-
-  setCursor(text_x, text_y);
-  setTextSize(1);
-  setTextColor(BLACK);
-  writeString(percent_str);
-}
+// Screen changes go out over the serial link ("stream" command). The link
+// has one writer at a time: the console sets stream_wanted and stops
+// writing, core 1 takes the link (stream_on) and streams, and once
+// stream_wanted is cleared hands it back after its last whole packet.
+static volatile bool stream_wanted; // set by the console
+static volatile bool stream_on;     // core 1 is writing the link
+static bool stream_capturing;       // core 1 only: a frame is being packed
 
 void draw_woe_frolic_dread_malice_percentages(Box *box, BoxAnim *anim) {
   int top_of_anim_box_y = box->y - anim->current_anim_height;
@@ -205,78 +147,108 @@ void draw_woe_frolic_dread_malice_percentages(Box *box, BoxAnim *anim) {
   }
 }
 
+// ==================================================
+// === chrome redraws -- under the sprites, from the draw queue
+// ==================================================
+// The header, the box values and the box animation can lie under a boid.
+// Like the grid they are drawn from the VGA draw queue between a sprite
+// hide and show, so the sprites are lifted first and save what is under
+// them again afterwards. Core 0 only, as the queue is.
+static bool sprite_bracket_open;
+
+// Queue a redraw, hiding the sprites ahead of the first one
+static void sprite_bracket_defer(short y, short h, VgaDrawFn fn, void *arg,
+                                 int data) {
+  if (!sprite_bracket_open) {
+    sprite_layer_hide();
+    sprite_bracket_open = true;
+  }
+  vga_draw_defer(y, h, fn, arg, data);
+}
+
+// Queue showing the sprites again, if any redraws were queued. Call before
+// yielding.
+static void sprite_bracket_close(void) {
+  if (sprite_bracket_open) {
+    sprite_layer_show();
+    sprite_bracket_open = false;
+  }
+}
+
+// Restoring the header wipes the old fill and percentage
+static void paint_header(void *arg, int progress) {
+  (void)arg;
+  int progress_bar_fill_width = (PROGRESS_W * progress) / 100;
+  static_layer_restore(&header_layer);
+  fillRect(PROGRESS_X, PROGRESS_Y, progress_bar_fill_width, PROGRESS_H,
+           WHITE); // WHITE fill based on progress
+
+  // Draw Ocula text on top of the progress bar
+  setCursor(PROGRESS_X + 10, PROGRESS_Y + 10);
+  setTextColor(RED);
+  setTextSize(2);
+  writeString("Ocula");
+
+  // Draw percentage
+  char percent_str[5];
+  sprintf(percent_str, "%d%%", progress);
+  setTextColor(DARK_BLUE);
+  setCursor(PROGRESS_X + progress_bar_fill_width + 5, PROGRESS_Y + 10);
+  setTextSize(2);
+  writeString(percent_str);
+}
+
+// A woe frolic dread or malice box's value, over its frame
+static void paint_box_value(void *arg, int percentage) {
+  Box *box = arg;
+  static_layer_restore(&box_layers[box - game_state.boxes]);
+  draw_box_value(box->x, box->y, box->width, box->height, percentage);
+}
+
+// One step of a box animation: data is whether it grows, and its height
+// before and after the step
+#define BOX_STEP(growing, from, to) ((growing) << 16 | (from) << 8 | (to))
+static void paint_box_anim(void *arg, int data) {
+  BoxAnim *anim = arg;
+  Box *box = &game_state.boxes[anim - game_state.box_anims];
+  bool growing = data >> 16;
+  int from = (data >> 8) & 0xff;
+  int to = data & 0xff;
+
+  if (growing) {
+    drawRect(box->x, box->y - from, box->width, BOX_ANIM_INCREMENT, BLACK);
+  } else {
+    // Clear the top strip that's disappearing this frame
+    fillRect(box->x, box->y - from, box->width, BOX_ANIM_INCREMENT, BLACK);
+  }
+  if (to > 0) {
+    drawRect(box->x, box->y - to, box->width, to, CYAN);
+  }
+  if (growing && to == BOX_ANIM_MAX_HEIGHT) {
+    draw_woe_frolic_dread_malice_percentages(box, anim);
+  }
+}
+
 static PT_THREAD(protothread_button_press(struct pt *pt)) {
   PT_BEGIN(pt);
-  static enum {
-    NOT_PRESSED,
-    MAYBE_PRESSED,
-    PRESSED,
-    MAYBE_NOT_PRESSED
-  } debounce_state = NOT_PRESSED;
-
-  static int possible_press = -1;
+  static Debouncer debouncer;
 
   while (1) {
-    bool buttonpress = gpio_get(BUTTON_PIN);
-
-    switch (debounce_state) {
-    case NOT_PRESSED:
-      if (buttonpress == 0) {
-        possible_press = buttonpress;
-        debounce_state = MAYBE_PRESSED;
-      }
-      break;
-    case MAYBE_PRESSED:
-      if (buttonpress == 0 && possible_press == 0) {
-        handle_cursor_refinement(&game_state);
-        debounce_state = PRESSED;
-      }
+    if (input_button(&debouncer, gpio_get(BUTTON_PIN), time_us_32())) {
+      handle_cursor_refinement(&game_state);
       if (game_state.play_state == START_SCREEN) {
         game_state.play_state = PLAYING;
         PT_SEM_SAFE_SIGNAL(pt, &start_game_sem);
       }
-      break;
-    case PRESSED:
-      if (buttonpress == 1)
-        debounce_state = MAYBE_NOT_PRESSED;
-      break;
-    case MAYBE_NOT_PRESSED:
-      if (buttonpress == 0)
-        debounce_state = PRESSED;
-      else
-        debounce_state = NOT_PRESSED;
-      break;
-    default:
-      break;
     }
 
     // Schedule to be called again in 30ms.
-    PT_YIELD_usec(30000);
+    PT_YIELD_usec(INPUT_BUTTON_PERIOD_US);
   }
 
   PT_END(pt);
 }
 
-void draw_cursor(GameState *state, int color) {
-  // int x = state->cursor.x + (CELL_WIDTH / 2);
-  // int y = state->cursor.y;
-  // int size = 12;
-
-  // // Draw diagonal lines at top
-  // for (int i = 0; i < size / 2; i++) {
-  //   drawPixel(x - i, y + i, color);
-  //   drawPixel(x + i, y + i, color);
-  // }
-
-  // // Draw main pointer
-  // drawVLine(x, y, size, color);
-  drawRect(game_state.cursor.x, game_state.cursor.y, game_state.cursor.width,
-           game_state.cursor.height, color);
-
-  // Draw horizontal line
-  // drawHLine(x - size / 2, y + size, size, color);
-}
-
 int get_VX_ADC() {
   adc_select_input(2);
   return adc_read();
@@ -293,74 +265,195 @@ static PT_THREAD(protothread_joystick(struct pt *pt)) {
   while (1) {
     int x_value = get_VX_ADC();
     int y_value = get_VY_ADC();
-    // Draw the cursor
-    draw_cursor(&game_state, BLACK);
-
-    if (x_value > X_RIGHT_THRESHOLD) {
-      // Command RIGHT
-      game_state.cursor.x += CELL_WIDTH;
-
-      if (game_state.cursor.x > RIGHT_MARGIN_GRID)
-        game_state.cursor.x = RIGHT_MARGIN_GRID;
-    } else if (x_value < X_LEFT_THRESHOLD) {
-      // Command LEFT
-      game_state.cursor.x -= CELL_WIDTH;
-      if (game_state.cursor.x < LEFT_MARGIN_GRID)
-        game_state.cursor.x = LEFT_MARGIN_GRID;
-    } else if (y_value > Y_DOWN_THRESHOLD) {
-      // Command DOWN
-      game_state.cursor.y += CELL_HEIGHT;
-      if (game_state.cursor.y > BOTTOM_MARGIN_GRID)
-        game_state.cursor.y = BOTTOM_MARGIN_GRID;
-    } else if (y_value < Y_UP_THRESHOLD) {
-      // Command UP
-      game_state.cursor.y -= CELL_HEIGHT;
-      if (game_state.cursor.y < TOP_MARGIN_GRID)
-        game_state.cursor.y = TOP_MARGIN_GRID;
+    // The cursor sprite follows on the next frame
+    switch (input_joystick(x_value, y_value, time_us_32())) {
+    case INPUT_RIGHT:
+      game_state_move_cursor(&game_state, 1, 0);
+      break;
+    case INPUT_LEFT:
+      game_state_move_cursor(&game_state, -1, 0);
+      break;
+    case INPUT_DOWN:
+      game_state_move_cursor(&game_state, 0, 1);
+      break;
+    case INPUT_UP:
+      game_state_move_cursor(&game_state, 0, -1);
+      break;
+    default:
+      break;
     }
-    draw_cursor(&game_state, CYAN);
 
     // Schedule to be called again in 70ms.
-    PT_YIELD_usec(70000);
+    PT_YIELD_usec(INPUT_JOYSTICK_PERIOD_US);
   }
 
   PT_END(pt);
 }
 
+#if VGA_LINE_COMPOSE
+// Line compositing budget: the cost of a bare line (the copy) and of each
+// sprite on it, from lines with and without sprites, and so how many
+// sprites fit on a line
+static void format_line_stats(char *buf, int size, int part) {
+  VgaLineStats s;
+  vga_line_stats(&s);
+  uint32_t bare_lines = s.lines - s.sprite_lines;
+  uint32_t base = bare_lines ? s.base_cycles / bare_lines : 0;
+  uint32_t per_sprite =
+      s.sprites ? (s.sprite_cycles - (uint64_t)base * s.sprite_lines) / s.sprites
+                : 0;
+  uint32_t fit = per_sprite && s.budget > base ? (s.budget - base) / per_sprite
+                                               : 0;
+  if (part == 0) {
+    snprintf(buf, size,
+             "# lines %lu, budget %lu cycles, max %lu, %lu late\n\r",
+             (unsigned long)s.lines, (unsigned long)s.budget,
+             (unsigned long)s.max_cycles, (unsigned long)s.late);
+  } else {
+    snprintf(buf, size,
+             "# line %lu cycles + %lu per sprite, up to %lu sprites on a "
+             "line (%lu skipped), %lu fit\n\r",
+             (unsigned long)base, (unsigned long)per_sprite,
+             (unsigned long)s.max_sprites,
+             (unsigned long)sprite_line_overflow(), (unsigned long)fit);
+  }
+}
+#endif
+
 // ==================================================
-// === progress bar animation thread
+// === serial commands
 // ==================================================
-static PT_THREAD(protothread_progress_bar(struct pt *pt)) {
+// Reads a command line like serial_read, but without echoing it, for
+// while the stream has the link
+static PT_THREAD(serial_read_quiet(struct pt *pt)) {
+  PT_BEGIN(pt);
+  static int n;
+  memset(pt_serial_in_buffer, 0, pt_buffer_size);
+  n = 0;
+  while (n < pt_buffer_size - 1) {
+    PT_YIELD_UNTIL(pt, (int)uart_is_readable(UART_ID));
+    char ch = uart_getc(UART_ID);
+    if (ch == '\r') {
+      break;
+    } else if (ch == pt_backspace) {
+      if (n > 0) {
+        pt_serial_in_buffer[--n] = 0;
+      }
+    } else {
+      pt_serial_in_buffer[n++] = ch;
+    }
+  }
+  PT_EXIT(pt);
+  PT_END(pt);
+}
+
+// Console output, dropped while the stream has the link
+#define console_write                                                          \
+  do {                                                                         \
+    if (!stream_wanted) {                                                      \
+      serial_write;                                                            \
+    }                                                                          \
+  } while (0)
+
+// "dump" prints the input log in the format sim_runner -r reads back,
+// "clear" empties it; "stats" prints the scheduler telemetry for both
+// cores, "reset" zeroes it; "stream" turns frame streaming on and off.
+// While streaming, commands are still read but nothing is echoed or
+// printed, so only stream packets go out on the link.
+static PT_THREAD(protothread_serial(struct pt *pt)) {
   PT_BEGIN(pt);
-  static int begin_time;
-  static int spare_time;
-  static int new_progress;
-  static int bad_numbers;
+  static char cmd[16];
+  static int i, count;
+  static const InputEvent *ev;
+  static int core;
+  static StreamStats stream_stats;
 
   while (1) {
-    begin_time = time_us_32();
-    ProgressBarAnimation *progress_bar = &game_state.progress_bar;
-
-    switch (progress_bar->anim_state) {
-    case ANIMATION_IDLE:
-      break;
-    case ANIMATION_GROWING:
-      bad_numbers =
-          game_state.total_bad_numbers == 0 ? 1 : game_state.total_bad_numbers;
-      new_progress = (100 - progress_bar->current_progress) / bad_numbers;
-      progress_bar->current_progress += new_progress;
-      if (progress_bar->current_progress >= 100) {
-        progress_bar->current_progress = 100;
-        game_state.play_state = GAME_WON;
+    if (stream_wanted) {
+      PT_SPAWN(pt, &pt_serialin, serial_read_quiet(&pt_serialin));
+    } else {
+      // Wait for core 1 to hand the link back after streaming
+      PT_YIELD_UNTIL(pt, !stream_on);
+      sprintf(pt_serial_out_buffer, "cmd> ");
+      serial_write;
+      serial_read;
+    }
+    cmd[0] = 0;
+    sscanf(pt_serial_in_buffer, "%15s", cmd);
+
+    if (strcmp(cmd, "dump") == 0) {
+      count = input_log_count();
+      sprintf(pt_serial_out_buffer, "# input log: %d events, %lu dropped\n\r",
+              count, (unsigned long)input_log_dropped());
+      console_write;
+      sprintf(pt_serial_out_buffer, "# seed %lu\n\r", (unsigned long)game_seed);
+      console_write;
+      for (i = 0; i < count; i++) {
+        ev = input_log_get(i);
+        sprintf(pt_serial_out_buffer, "%lu %u %u %u\n\r",
+                (unsigned long)ev->t_us, ev->adc_x, ev->adc_y, ev->button);
+        console_write;
       }
-      progress_bar->anim_state = ANIMATION_IDLE;
-      break;
+    } else if (strcmp(cmd, "clear") == 0) {
+      input_log_clear();
+    } else if (strcmp(cmd, "stats") == 0) {
+      sprintf(pt_serial_out_buffer, "# scheduler passes %d %d\n\r",
+              pt_cores[0].sched_count, pt_cores[1].sched_count);
+      console_write;
+      sprintf(pt_serial_out_buffer, PT_STATS_HEADER);
+      console_write;
+      for (core = 0; core < 2; core++) {
+        count = pt_cores[core].task_count;
+        for (i = 0; i < count; i++) {
+          pt_stats_format(pt_serial_out_buffer, pt_buffer_size, core, i);
+          console_write;
+        }
+      }
+#if VGA_LINE_COMPOSE
+      for (i = 0; i < 2; i++) {
+        format_line_stats(pt_serial_out_buffer, pt_buffer_size, i);
+        console_write;
+      }
+#endif
+      stream_get_stats(&stream_stats);
+      sprintf(pt_serial_out_buffer,
+              "# stream %lu frames, %lu dropped, %lu cut, %lu bytes\n\r",
+              (unsigned long)stream_stats.frames_sent,
+              (unsigned long)stream_stats.frames_dropped,
+              (unsigned long)stream_stats.frames_cut,
+              (unsigned long)stream_stats.bytes_sent);
+      console_write;
+    } else if (strcmp(cmd, "stream") == 0) {
+      // A new viewer has seen nothing yet. Core 1 has finished with the
+      // tiles, as the link is back with the console.
+      if (!stream_wanted) {
+        stream_reset();
+      }
+      stream_wanted = !stream_wanted;
+    } else if (strcmp(cmd, "reset") == 0) {
+      pt_stats_reset();
+#if VGA_LINE_COMPOSE
+      vga_line_stats_reset();
+#endif
+    } else if (cmd[0]) {
+      sprintf(pt_serial_out_buffer,
+              "commands: dump, clear, stats, reset, stream\n\r");
+      console_write;
     }
+  }
+  PT_END(pt);
+}
 
-    spare_time = FRAME_RATE - (time_us_32() - begin_time);
-    if (spare_time < 0)
-      spare_time = 0;
-    PT_YIELD_usec(spare_time);
+// ==================================================
+// === progress bar animation thread
+// ==================================================
+static PT_THREAD(protothread_progress_bar(struct pt *pt)) {
+  PT_BEGIN(pt);
+
+  while (1) {
+    game_state_update_progress(&game_state);
+
+    PT_WAIT_FRAME(pt, vga_frame_count + FRAMES_PER_TICK);
   }
   PT_END(pt);
 }
@@ -370,8 +463,6 @@ static PT_THREAD(protothread_progress_bar(struct pt *pt)) {
 // ==================================================
 static PT_THREAD(protothread_graphics(struct pt *pt)) {
   PT_BEGIN(pt);
-  static int begin_time;
-  static int spare_time;
   static char progress_str[15]; // Declare the progress string buffer
 
   // ---- To Start the game; user has to press some button ---- //
@@ -382,235 +473,220 @@ static PT_THREAD(protothread_graphics(struct pt *pt)) {
   writeString("Press button to start!");
   PT_SEM_WAIT(pt, &start_game_sem);
 
-  game_state_init(&game_state, time_us_32());
-
-  // Variables for grid drawing
-  static const int cell_width = 40;   // Width of each grid cell
-  static const int cell_height = 40;  // Height of each grid cell
-  static const int grid_start_x = 10; // Starting X position of the grid
-  static int grid_start_y = 60;       // Starting Y position of the grid
-  static char num_str[2] = {
-      0, 0}; // String to hold the number (plus null terminator)
-
-  // Clear the screen first
-  fillRect(0, 0, 640, 480, BLACK);
-
-  // Progress bar
-  int progress_bar_width = (COLS * cell_width);
-  int progress_bar_y = 20;
-  int progress_bar_height = 30;
-  int progress_bar_x = grid_start_x + 10;
-
-  // Lumon Logo - to the right of the progress bar
-  int logo_w = 70;
-  int logo_h = 40;
-  int logo_cx = progress_bar_width - 10;
-  int logo_cy = progress_bar_y + (progress_bar_height / 2);
-
-  draw_lumon_logo(logo_cx, logo_cy, logo_w, logo_h);
-
-  // Reset text properties for grid numbers
-  setTextSize(1);
-  setTextColor2(WHITE, BLACK);
-
-  grid_start_y = progress_bar_y + progress_bar_height + 30; // Start grid below
-  // draw straight line at the top
-  // drawHLine(grid_start_x, grid_start_y, COLS * cell_width, CYAN);
-  // // draw straight line at the bottom
-  // drawHLine(grid_start_x, grid_start_y + ((ROWS + 1) * cell_height),
-  //           COLS * cell_width, CYAN);
-  // move grid down
-
-  // Draw final botton box
-  fillRect(grid_start_x, 460, COLS * cell_width, 10, CYAN);
-  setCursor(((COLS * cell_width) / 2) - 40, 460 + 1);
-  setTextColor(BLACK);
-  setTextSize(1);
-  writeString("0x5D9EA : 0xB57135");
-
-  int wfdm_width = 60;
-  int wfdm_height = 10;
-  int wfdm_y = 420;
-  int wfdm_start_x = 40;
+  game_seed = seed_get();
+  game_state_init(&game_state, GRID_ROWS, GRID_COLS, game_seed);
+
+  // The cleared screen with the chrome is baked into flash (see
+  // bake_screen.c). Decode it over the whole frame buffer and take the
+  // layers from the screen, rather than clearing and rendering them.
+  chrome_init();
+  if (rle_decode(boot_screen_rle, sizeof(boot_screen_rle), vga_data_array,
+                 VGA_STRIDE * VGA_HEIGHT) == VGA_STRIDE * VGA_HEIGHT) {
+    chrome_capture();
+  } else {
+    // Image does not fit this build: draw it the slow way
+    fillRect(0, 0, VGA_WIDTH, VGA_HEIGHT, BLACK);
+    chrome_draw();
+  }
+  invalidate_grid();
 
   // int random_index = rand() % 4;
   // game_state.box_anims[random_index].anim_state = ANIM_GROWING;
 
-  setCursor(progress_bar_x + 10, progress_bar_y + 10);
-  setTextColor(RED);
-  setTextSize(2);
-  writeString("Ocula");
-
-  while (true) {
-    begin_time = time_us_32();
-    int progress_bar_fill_width =
-        (progress_bar_width * game_state.progress_bar.current_progress) / 100;
-
-    // Progress bar
-    drawRect(progress_bar_x, progress_bar_y, progress_bar_width,
-             progress_bar_height, CYAN);
-    fillRect(progress_bar_x, progress_bar_y, progress_bar_fill_width,
-             progress_bar_height, WHITE); // WHITE fill based on progress
-
-    // Draw Ocula text on top of the progress bar
-    setCursor(progress_bar_x + 10, progress_bar_y + 10);
-    setTextColor(RED);
-    setTextSize(2);
-    writeString("Ocula");
-
-    // Draw percentage
-    char percent_str[5];
-    sprintf(percent_str, "%d%%", game_state.progress_bar.current_progress);
-    setTextColor(DARK_BLUE);
-    setCursor(progress_bar_x + progress_bar_fill_width + 5,
-              progress_bar_y + 10);
-    setTextSize(2);
-    writeString(percent_str);
-
-    // Reset number positions, sizes, and animation flags before collision
-    for (int row = 0; row < ROWS; row++) {
-      for (int col = 0; col < COLS; col++) {
-
-        if (game_state.state[row][col].refined_last_frame == 1) {
-          int random_number = rand();
-          game_state.state[row][col].number = random_number % 10;
-          game_state.state[row][col].is_bad_number = (random_number & 0xF) > 14;
-          game_state.state[row][col].bad_number.bin_id = random_number % 4;
-          if (game_state.state[row][col].is_bad_number) {
-            game_state.total_bad_numbers++;
-          }
-        }
-
-        if (game_state.state[row][col].animated_last_frame_by_boid0 == 1 ||
-            game_state.state[row][col].animated_last_frame_by_boid1 == 1) {
-          // Clear the area with the correct size
-          fillRect(game_state.state[row][col].x, game_state.state[row][col].y,
-                   CELL_WIDTH, CELL_HEIGHT, BLACK);
-        }
-        game_state.state[row][col].x = GRID_START_X + (col * CELL_WIDTH);
-        game_state.state[row][col].y = GRID_START_Y + (row * CELL_HEIGHT);
-        game_state.state[row][col].size = 1;
-        game_state.state[row][col].animated_last_frame_by_boid0 = 0;
-        game_state.state[row][col].animated_last_frame_by_boid1 = 0;
-        game_state.state[row][col].refined_last_frame = 0;
-      }
-    }
-
-    // Update the boids
-    update_boids(&game_state);
-
-    // Check collisions and mark numbers for animation
-    check_collisions_and_animate(&game_state);
-
-    // Draw the numbers from the game state
-    for (int row = 0; row < ROWS; row++) {
-      for (int col = 0; col < COLS; col++) {
-        // convert number to string
-        num_str[0] = '0' + game_state.state[row][col].number;
-
-        // set text properties
-        setCursor(game_state.state[row][col].x + CELL_WIDTH / 2,
-                  game_state.state[row][col].y +
-                      CELL_HEIGHT / 2); // center text in cell
+  // What the dynamic parts over the layers last showed; -1 forces a draw
+  static int shown_progress;
+  static int shown_box_percentage[5];
+  shown_progress = -1;
+  for (int i = 0; i < 5; i++) {
+    shown_box_percentage[i] = -1;
+  }
 
-        if (game_state.state[row][col].is_bad_number) {
-          setTextColor(RED);
-        } else {
-          setTextColor(WHITE);
-        }
+  // Draw from the start of vertical blank, when the beam is off screen
+  static uint32_t tick_frame;
+  PT_WAIT_VBLANK(pt);
+  tick_frame = vga_frame_count;
 
-        setTextSize(game_state.state[row][col].size);
+  while (true) {
+    // Advance the simulation: refresh cells, move boids, check collisions
+    game_state_update(&game_state);
 
-        // draw the number
-        writeString(num_str);
-      }
-    }
+    // Draw the numbers that changed since the last frame
+    draw_grid(&game_state);
 
     //  update the game state
     for (int i = 0; i < 5; i++) {
       game_state_update_boxes(&game_state.boxes[i],
-                              wfdm_start_x + (wfdm_width + 60) * i, wfdm_y,
-                              wfdm_width, wfdm_height, 50);
+                              WFDM_X + WFDM_SPACING * i, WFDM_Y, WFDM_W,
+                              WFDM_H, 50);
     }
 
-    // Draw the woe frolic dread and malice boxes
-    for (int i = 0; i < 5; i++) {
-      draw_boxes(game_state.boxes[i].x, game_state.boxes[i].y,
-                 game_state.boxes[i].width, game_state.boxes[i].height,
-                 game_state.boxes[i].percentage, i);
+    // The progress bar only changes with the progress
+    int progress = game_state.progress_bar.current_progress;
+    if (progress != shown_progress) {
+      sprite_bracket_defer(HEADER_Y, HEADER_H, paint_header, NULL, progress);
+      shown_progress = progress;
     }
 
-    spare_time = FRAME_RATE - (time_us_32() - begin_time);
-    PT_YIELD_usec(spare_time);
+    // Redraw a woe frolic dread and malice box over its frame when its
+    // percentage changes
+    for (int i = 0; i < 5; i++) {
+      Box *box = &game_state.boxes[i];
+      if (box->percentage != shown_box_percentage[i]) {
+        sprite_bracket_defer(box_layers[i].y, box_layers[i].surface.h,
+                             paint_box_value, box, box->percentage);
+        shown_box_percentage[i] = box->percentage;
+      }
+    }
+    sprite_bracket_close();
+
+    // Each tick has FRAMES_PER_TICK refreshes to finish in. Running past
+    // that is an overrun; pick up at the next vblank rather than run late
+    // ticks back to back.
+    tick_frame += FRAMES_PER_TICK;
+    if ((int32_t)(vga_frame_count - tick_frame) >= 0) {
+      PT_FRAME_OVERRUN();
+      tick_frame = vga_frame_count + 1;
+    }
+    PT_WAIT_FRAME(pt, tick_frame);
   }
   PT_END(pt);
 } // graphics thread
 
+// ==================================================
+// === raster thread -- RUNNING on core 0
+// ==================================================
+// Runs queued draws (the grid cells) as the beam moves clear of them
+static PT_THREAD(protothread_raster(struct pt *pt)) {
+  PT_BEGIN(pt);
+  while (true) {
+    PT_YIELD_UNTIL(pt, vga_draw_pending());
+    vga_draw_flush();
+    PT_YIELD(pt);
+  }
+  PT_END(pt);
+}
+
 // ==================================================
 // === box animation thread on core 0
 // ==================================================
-// the on-board LED blinks
+// Grows a box when its anim state says so, shows the percentages for 3s,
+// then shrinks it. The drawing goes through the draw queue (see
+// sprite_bracket_defer), so this runs on core 0 with the queue.
 static PT_THREAD(protothread_graphics_too(struct pt *pt)) {
   PT_BEGIN(pt);
-  static int spare_time;
-  static int begin_time;
   static int i;
   static BoxAnim *anim;
   static Box *box;
+  static int from;
 
   while (1) {
-    begin_time = time_us_32();
     for (i = 0; i < 5; i++) {
       anim = &game_state.box_anims[i];
       box = &game_state.boxes[i];
+      from = anim->current_anim_height;
       switch (anim->anim_state) {
       case ANIM_GROWING:
-        drawRect(box->x, box->y - anim->current_anim_height, box->width,
-                 BOX_ANIM_INCREMENT, BLACK);
         anim->current_anim_height += BOX_ANIM_INCREMENT;
         if (anim->current_anim_height >= BOX_ANIM_MAX_HEIGHT) {
           anim->current_anim_height = BOX_ANIM_MAX_HEIGHT;
-          // Draw the final, fully grown box
-          drawRect(box->x, box->y - anim->current_anim_height, box->width,
-                   anim->current_anim_height, CYAN);
+          // Draw the final, fully grown box with its percentages
+          sprite_bracket_defer(box->y - BOX_ANIM_MAX_HEIGHT,
+                               BOX_ANIM_MAX_HEIGHT, paint_box_anim, anim,
+                               BOX_STEP(1, from, BOX_ANIM_MAX_HEIGHT));
+          sprite_bracket_close();
           // Wait a 3s before transitioning to shrinking
-          draw_woe_frolic_dread_malice_percentages(box, anim);
-          PT_YIELD_usec(3000000);
-          // Clear the box area before transitioning to shrinking
+          PT_WAIT_FRAME(pt, vga_frame_count + BOX_HOLD_FRAMES);
           anim->anim_state = ANIM_SHRINKING;
         } else {
           // Draw the growing box
-          drawRect(box->x, box->y - anim->current_anim_height, box->width,
-                   anim->current_anim_height, CYAN);
+          sprite_bracket_defer(box->y - anim->current_anim_height,
+                               anim->current_anim_height, paint_box_anim,
+                               anim,
+                               BOX_STEP(1, from, anim->current_anim_height));
         }
         break;
       case ANIM_SHRINKING:
-        // Clear the top strip that's disappearing this frame
-        fillRect(box->x, box->y - anim->current_anim_height, box->width,
-                 BOX_ANIM_INCREMENT, // Height of the strip to clear
-                 BLACK);
         anim->current_anim_height -= BOX_ANIM_INCREMENT;
         if (anim->current_anim_height <= 0) {
           anim->current_anim_height = 0;
           anim->anim_state = ANIM_IDLE;
-        } else {
-          // Draw the shrinking box
-          drawRect(box->x, box->y - anim->current_anim_height, box->width,
-                   anim->current_anim_height, CYAN);
         }
+        // Clear the top strip and draw what is left of the box
+        sprite_bracket_defer(box->y - from, from, paint_box_anim, anim,
+                             BOX_STEP(0, from, anim->current_anim_height));
         break;
 
       case ANIM_IDLE:
         break;
       }
     }
+    sprite_bracket_close();
 
     // NEVER exit while
-    spare_time = FRAME_RATE - (time_us_32() - begin_time);
-    PT_YIELD_usec(spare_time);
+    PT_WAIT_FRAME(pt, vga_frame_count + FRAMES_PER_TICK);
   } // END WHILE(1)
   PT_END(pt);
-} // blink thread
+} // box animation thread
+
+// ==================================================
+// === frame streaming on core 1
+// ==================================================
+// While streaming, the screen's changes are packed once a game tick (see
+// stream.h), yielding between bands of tiles; stream_view on the host
+// turns them back into images
+static PT_THREAD(protothread_stream(struct pt *pt)) {
+  PT_BEGIN(pt);
+  while (1) {
+    PT_WAIT_FRAME(pt, vga_frame_count + FRAMES_PER_TICK);
+    if (stream_wanted && stream_on && stream_frame_begin(vga_frame_count)) {
+      stream_capturing = true;
+      while (stream_frame_step()) {
+        PT_YIELD(pt);
+      }
+      stream_frame_end();
+      stream_capturing = false;
+    }
+  }
+  PT_END(pt);
+}
+
+// Tops up the UART FIFO from the stream ring, never waiting on it. The
+// ring only ever holds whole packets, so once it is empty with no frame
+// being packed, the last packet is out and the link can go back to the
+// console.
+#define STREAM_SEND_US 1000 // a third of the FIFO at 115200 baud
+static PT_THREAD(protothread_stream_send(struct pt *pt)) {
+  PT_BEGIN(pt);
+  static uint8_t byte;
+  while (1) {
+    if (stream_wanted) {
+      stream_on = true;
+    }
+    while (uart_is_writable(UART_ID) && stream_read(&byte, 1)) {
+      uart_putc_raw(UART_ID, byte);
+    }
+    if (!stream_wanted && !stream_capturing && stream_queued() == 0) {
+      stream_on = false;
+    }
+    PT_YIELD_usec(STREAM_SEND_US);
+  }
+  PT_END(pt);
+}
+
+// ==================================================
+// === task pool worker on core 1
+// ==================================================
+// Helps with the jobs core 0 splits up (collision bands); sleeps with the
+// rest of core 1 while there is nothing queued
+static PT_THREAD(protothread_task_worker(struct pt *pt)) {
+  PT_BEGIN(pt);
+  while (1) {
+    PT_YIELD_UNTIL(pt, task_pool_pending());
+    while (task_pool_work()) {
+    }
+  }
+  PT_END(pt);
+}
 
 // ========================================
 // === core 1 main -- started in main below
@@ -618,8 +694,10 @@ static PT_THREAD(protothread_graphics_too(struct pt *pt)) {
 void core1_main() {
   //
   //  === add threads  ====================
-  pt_add_thread(protothread_graphics_too);
-  pt_add_thread(protothread_progress_bar); // Add the new progress bar thread
+  pt_add_thread(protothread_progress_bar);
+  pt_add_thread(protothread_task_worker);
+  pt_add_thread(protothread_stream);
+  pt_add_thread(protothread_stream_send);
   pt_schedule_start;
 }
 
@@ -643,8 +721,20 @@ int main() {
   adc_select_input(0);
 
   // Initialize the VGA screen
+#if VGA_LINE_COMPOSE
+  // Sprites are drawn into each line at scanout, not into the framebuffer
+  sprite_layer_set_scanout(true);
+  vga_set_line_hook(sprite_compose_line);
+#endif
   initVGA();
 
+  // Both cores sleep between thread wake times instead of polling, and
+  // run the frame threads by earliest deadline
+  pt_sched_method = SCHED_EDF;
+
+  // Deques and their spinlocks, before core 1 can look at them
+  task_pool_init();
+
   // start core 1 threads
   multicore_reset_core1();
   multicore_launch_core1(&core1_main);
@@ -652,8 +742,11 @@ int main() {
   // === config threads ========================
   // for core 0
   pt_add_thread(protothread_graphics);
+  pt_add_thread(protothread_raster);
+  pt_add_thread(protothread_graphics_too);
   pt_add_thread(protothread_joystick);
   pt_add_thread(protothread_button_press);
+  pt_add_thread(protothread_serial);
   //
   // === initalize the scheduler ===============
   pt_schedule_start;
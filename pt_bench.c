@@ -0,0 +1,97 @@
+/**
+ * Protothread scheduler benchmark (host build only)
+ *
+ * Measures the cost of one context switch -- a scheduler pass calling a
+ * thread that yields straight back -- against the number of threads on a
+ * core, for each scheduling method. Threads either yield unconditionally
+ * (polled every pass) or with a zero-length timed yield (so the sleep and
+ * EDF schedulers queue them in the wake-time heap).
+ *
+ * Build with the SDK host platform:
+ *   cmake -S . -B build-host -DPICO_PLATFORM=host && cmake --build build-host
+ *
+ * Usage: pt_bench [switches per measurement, default 2000000]
+ */
+#include "hardware/sync.h"
+#include "hardware/uart.h"
+#include "pico/multicore.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+// protothreads header
+#include "pt_cornell_rp2040_v1_3.h"
+
+static long switches;
+
+static PT_THREAD(protothread_polled(struct pt *pt)) {
+  PT_BEGIN(pt);
+  while (1) {
+    switches++;
+    PT_YIELD(pt);
+  }
+  PT_END(pt);
+}
+
+// A zero-length PT_YIELD_usec. The macro's static wake time would be
+// shared by all copies of this thread, so set the wake time directly.
+static PT_THREAD(protothread_timed(struct pt *pt)) {
+  PT_BEGIN(pt);
+  while (1) {
+    switches++;
+    PT_SET_WAKE(time_us_64());
+    PT_YIELD(pt);
+  }
+  PT_END(pt);
+}
+
+// ns per switch with n copies of thread on core 0
+static double measure(int method, char (*thread)(struct pt *pt), int n,
+                      long target) {
+  struct pt_core *c = &pt_cores[0];
+  pt_core_reset(c);
+  pt_sched_method = method;
+  for (int i = 0; i < n; i++) {
+    pt_core_add(c, thread, "bench");
+  }
+  // first calls run the threads up to their first yield
+  pt_sched_pass(c);
+
+  switches = 0;
+  uint64_t start = time_us_64();
+  while (switches < target) {
+    pt_sched_pass(c);
+  }
+  return (time_us_64() - start) * 1000.0 / switches;
+}
+
+int main(int argc, char **argv) {
+  long target = argc > 1 ? atol(argv[1]) : 2000000;
+  static const struct {
+    const char *name;
+    int method;
+    char (*thread)(struct pt *pt);
+  } runs[] = {
+      {"round-robin", SCHED_ROUND_ROBIN, protothread_polled},
+      {"round-robin/timed", SCHED_ROUND_ROBIN, protothread_timed},
+      {"sleep", SCHED_SLEEP, protothread_polled},
+      {"sleep/timed", SCHED_SLEEP, protothread_timed},
+      {"edf/timed", SCHED_EDF, protothread_timed},
+  };
+
+  printf("ns per context switch, %ld switches each\n", target);
+  printf("%-18s", "threads");
+  for (int n = 1; n <= PT_MAX_THREADS; n *= 2) {
+    printf(" %7d", n);
+  }
+  printf("\n");
+  for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+    printf("%-18s", runs[r].name);
+    for (int n = 1; n <= PT_MAX_THREADS; n *= 2) {
+      printf(" %7.1f", measure(runs[r].method, runs[r].thread, n, target));
+      fflush(stdout);
+    }
+    printf("\n");
+  }
+  return 0;
+}
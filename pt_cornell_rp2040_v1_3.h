@@ -434,10 +434,15 @@ struct pt {
  *
  * \hideinitializer
  */
+// The core whose scheduler state the macros use. Host tools that run
+// both cores' schedulers from one thread define it before the include.
+#ifndef PT_CORE_NUM
+#define PT_CORE_NUM() get_core_num()
+#endif
 // modified 9/26/23 for priority scheduler
 // this will be set to zero by the scheduler,
 // and set to one, if a thread actually executes
-int pt_executed, pt_executed1 ;
+#define PT_MARK_EXECUTED() (pt_cores[PT_CORE_NUM()].executed = 1)
 //
 #define PT_YIELD(pt)				\
   do {						\
@@ -446,11 +451,7 @@ int pt_executed, pt_executed1 ;
     if(PT_YIELD_FLAG == 0) {			\
       return PT_YIELDED;			\
     }	 \
-    if(get_core_num()==1){ \
-    pt_executed1 = 1;;\
-    }  else {\
-      pt_executed = 1;\
-    }\
+    PT_MARK_EXECUTED(); \
   } while(0)
 
 /**
@@ -472,11 +473,7 @@ int pt_executed, pt_executed1 ;
     if((PT_YIELD_FLAG == 0) || !(cond)) {	\
       return PT_YIELDED;                  \
     }	\
-    if(get_core_num()==1){ \
-    pt_executed1 = 1;\
-    }  else {\
-      pt_executed = 1;\
-    }\
+    PT_MARK_EXECUTED(); \
   } while(0)
 
   /**/
@@ -562,9 +559,16 @@ struct pt_sem {
 // max time of about 300,000 years
 // uint64_t time_us_64 (void)
 
+// the wake time of a timed yield is left here for the sleep scheduler
+// (SCHED_SLEEP), which then does not call the thread until it is due
+#define PT_SET_WAKE(t) do{ \
+  pt_cores[PT_CORE_NUM()].wake_time = (t) ;\
+} while(0)
+
 #define PT_YIELD_usec(delay_time)  \
     do { static uint64_t time_thread ;\
     time_thread = time_us_64() + (uint64_t)delay_time ; \
+    PT_SET_WAKE(time_thread); \
     PT_YIELD_UNTIL(pt, (time_us_64() >= time_thread)); \
     } while(0);
 
@@ -577,6 +581,7 @@ struct pt_sem {
 //
 #define PT_YIELD_INTERVAL(interval_time)  \
     do { \
+    PT_SET_WAKE(pt_interval_marker); \
     PT_YIELD_UNTIL(pt, (uint32_t)(time_us_64() >= pt_interval_marker)); \
     pt_interval_marker = time_us_64() + (uint64_t)interval_time; \
     } while(0);
@@ -605,11 +610,7 @@ spin_lock_t * sem_lock ;
       spin_unlock_unsafe (sem_lock); 	\
       return PT_YIELDED;      \
     }		\
-   if(get_core_num()==1){ \
-    pt_executed1 = 1;;\
-    }  else {\
-      pt_executed = 1;\
-    }\
+    PT_MARK_EXECUTED(); \
     --(s)->count;	\
     spin_unlock_unsafe (sem_lock); 	\
   } while(0)
@@ -648,11 +649,7 @@ spin_lock_t * lock_lock ;
       spin_unlock_unsafe (lock_lock) ; \
       return PT_YIELDED;                        \
   }						\
-  if(get_core_num()==1){ \
-    pt_executed1 = 1;;\
-    }  else {\
-      pt_executed = 1;\
-    }\
+  PT_MARK_EXECUTED(); \
   spin_lock_unsafe_blocking (s); \
   spin_unlock_unsafe (lock_lock) ; \
 } while(0)
@@ -685,69 +682,105 @@ do{ \
 // === thread structures ===
 // thread control structs
 
-// A modified scheduler
-static struct pt pt_sched ;
-// second core
-static struct pt pt_sched1 ;
-
-// count of defined tasks
-int pt_task_count = 0 ;
-int pt_task_count1 = 0 ;
-
 // The task structure
 struct ptx {
 	struct pt pt;              // thread context
 	int num;                    // thread number
 	char (*pf)(struct pt *pt); // pointer to thread function
+	const char *name;          // for the stats report
+	uint64_t wake;             // SCHED_SLEEP: due time, 0 if not sleeping
+	uint64_t deadline;         // SCHED_EDF: deadline of the pending run
+	uint32_t period;           // periodic threads only, see PT_YIELD_PERIOD
+	uint32_t rel_deadline;     //   deadline after each release
+	uint64_t release;          //   start of the current period
+};
+
+// =========================================
+// If defined, accumulates execution stats, 
+//    but slows down scheduler!!
+// Kept for every scheduler and both cores. A "run" is a call in which
+// the thread got past its wait and did work, a "poll" is a call that
+// found the wait condition still false.
+#define sched_stats
+struct pt_stats {
+	uint32_t runs, polls;
+	uint64_t total_us;      // time spent in runs
+	uint32_t max_us;        // longest single run
+	uint64_t last_run;      // start of the previous run
+	uint64_t total_gap_us;  // time between the starts of runs
+	uint32_t max_gap_us;
+	uint32_t overruns;      // frames over budget, see PT_FRAME_OVERRUN
+	uint32_t misses;        // periods that ended after their deadline
 };
 
 // === extended structure for scheduler ===============
-// an array of task structures
-#define MAX_THREADS 10
-static struct ptx pt_thread_list[MAX_THREADS];
-// core 1
-static struct ptx pt_thread_list1[MAX_THREADS];
+// Threads per core. Each thread costs about 100 bytes of RAM per core;
+// define PT_MAX_THREADS before including this file to change it.
+#ifndef PT_MAX_THREADS
+#define PT_MAX_THREADS 32
+#endif
+#define MAX_THREADS PT_MAX_THREADS
+
+// Threads in a timed yield, for SCHED_SLEEP and SCHED_EDF
+struct pt_sleep_queue {
+	unsigned short heap[PT_MAX_THREADS];  // thread numbers, earliest wake first
+	int n;
+	uint32_t ready[(PT_MAX_THREADS + 31) / 32];  // SCHED_EDF: due, not yet run
+};
+
+// Everything the scheduler keeps for one core
+struct pt_core {
+	struct ptx threads[PT_MAX_THREADS];
+	struct pt_stats stats[PT_MAX_THREADS];
+	int task_count;
+	int executed;        // set when the thread being called actually ran
+	int current;         // thread being called
+	uint64_t wake_time;  // wake time left by a timed yield, 0 if none
+	int sched_count;     // scheduler passes
+	struct pt_sleep_queue sleepers;
+	struct pt sched;
+};
+struct pt_core pt_cores[2];
+#define pt_this_core() (&pt_cores[PT_CORE_NUM()])
 
 // see https://github.com/edartuz/c-ptx/tree/master/src
 // and the license above
-// add an entry to the thread list
-//struct ptx *pt_add( char (*pf)(struct pt *pt), int rate) {
-int pt_add( char (*pf)(struct pt *pt)) {
-	if (pt_task_count < (MAX_THREADS)) {
+// add an entry to a core's thread list; returns its number, -1 if full
+static int pt_core_add(struct pt_core *c, char (*pf)(struct pt *pt), const char *name){
+	if (c->task_count < PT_MAX_THREADS) {
         // get the current thread table entry 
-		struct ptx *ptx = &pt_thread_list[pt_task_count];
+		struct ptx *ptx = &c->threads[c->task_count];
+		memset(ptx, 0, sizeof(*ptx));
         // enter the tak data into the thread table
-		ptx->num   = pt_task_count;
+		ptx->num   = c->task_count;
         // function pointer
 		ptx->pf    = pf;
+		ptx->name  = name;
     //
 		PT_INIT( &ptx->pt );
+		memset(&c->stats[c->task_count], 0, sizeof(c->stats[0]));
         // count of number of defined threads
-		pt_task_count++;
+		c->task_count++;
         // return current entry
-        return pt_task_count-1;
+        return c->task_count-1;
 	}
-	return 0;
+	return -1;
+}
+
+// core 0 / core 1 -- add an entry to the thread list
+int pt_add( char (*pf)(struct pt *pt)) {
+	int i = pt_core_add(&pt_cores[0], pf, 0);
+	return i < 0 ? 0 : i;
 }
 
-// core 1 -- add an entry to the thread list
-//struct ptx *pt_add( char (*pf)(struct pt *pt), int rate) {
 int pt_add1( char (*pf)(struct pt *pt)) {
-	if (pt_task_count1 < (MAX_THREADS)) {
-        // get the current thread table entry 
-		struct ptx *ptx = &pt_thread_list1[pt_task_count1];
-        // enter the tak data into the thread table
-		ptx->num   = pt_task_count1;
-        // function pointer
-		ptx->pf    = pf;
-    //
-		PT_INIT( &ptx->pt );
-        // count of number of defined threads
-		pt_task_count1++;
-        // return current entry
-        return pt_task_count1-1;
-	}
-	return 0;
+	int i = pt_core_add(&pt_cores[1], pf, 0);
+	return i < 0 ? 0 : i;
+}
+
+// drop all threads of a core (for tools that build thread sets repeatedly)
+static void pt_core_reset(struct pt_core *c){
+	memset(c, 0, sizeof(*c));
 }
 
 /* Scheduler
@@ -780,159 +813,304 @@ SOFTWARE.
 // choose schedule method
 #define SCHED_ROUND_ROBIN 0
 #define SCHED_PRIORITY    1
+// Threads in a timed yield are kept in a min-heap by wake time and not
+// called until due; the core waits in __wfe() when nothing is ready
+#define SCHED_SLEEP       2
+// As SCHED_SLEEP, but of the threads that are due the one with the
+// earliest deadline runs first. Periodic threads (pt_add_thread_periodic)
+// have deadline release+rel_deadline; other timed threads are due by
+// their wake time.
+#define SCHED_EDF         3
 // default is round robin
 int pt_sched_method = SCHED_ROUND_ROBIN ;
 
-// =========================================
-// If defined, accumulates execution stats, 
-//    but slows down scheduler!!
-#define sched_stats
-int sched_thread_stats[MAX_THREADS], sched_thread_stats1[MAX_THREADS] ;
-uint64_t sched_thread_time[MAX_THREADS], thread_time ;
-uint64_t sched_thread_time1[MAX_THREADS], thread_time1 ;
-int sched_count, sched_count1 ;
-// =========================================
+static inline void pt_stats_update(struct pt_stats *s, uint64_t start, int executed){
+	// the first call runs from PT_BEGIN without passing a wait
+	if (!executed && (s->runs || s->polls)) {
+		s->polls++ ;
+		return ;
+	}
+	uint32_t run = (uint32_t)(time_us_64() - start) ;
+	s->runs++ ;
+	s->total_us += run ;
+	if (run > s->max_us) s->max_us = run ;
+	if (s->last_run) {
+		uint32_t gap = (uint32_t)(start - s->last_run) ;
+		s->total_gap_us += gap ;
+		if (gap > s->max_gap_us) s->max_gap_us = gap ;
+	}
+	s->last_run = start ;
+}
+
+// called by a frame thread whose frame took longer than its period
+#ifdef sched_stats
+#define PT_FRAME_OVERRUN() do{ \
+  struct pt_core *pt_c = pt_this_core() ;\
+  pt_c->stats[pt_c->current].overruns++ ;\
+} while(0)
+#else
+#define PT_FRAME_OVERRUN() do{} while(0)
+#endif
+
+// one line of the stats report for thread i on a core
+// (name, runs, polls, total ms, max us, mean/max gap us, overruns, misses)
+static int pt_stats_format(char *buf, int size, int core, int i){
+	struct pt_stats *s = &pt_cores[core].stats[i] ;
+	const char *name = pt_cores[core].threads[i].name ;
+	uint32_t gaps = s->runs > 1 ? s->runs - 1 : 1 ;
+	return snprintf(buf, size, "%d %-20.20s %8lu %9lu %8lu %6lu %7lu %7lu %4lu %4lu\n\r",
+		core, name ? name : "?", (unsigned long)s->runs, (unsigned long)s->polls,
+		(unsigned long)(s->total_us / 1000), (unsigned long)s->max_us,
+		(unsigned long)(s->total_gap_us / gaps), (unsigned long)s->max_gap_us,
+		(unsigned long)s->overruns, (unsigned long)s->misses) ;
+}
+#define PT_STATS_HEADER "c thread                   runs     polls total_ms max_us gap_avg gap_max over miss\n\r"
+
+static void pt_stats_reset(void){
+	for (int core=0; core<2; core++) {
+		memset(pt_cores[core].stats, 0, sizeof(pt_cores[core].stats)) ;
+		pt_cores[core].sched_count = 0 ;
+	}
+}
+
+// call thread i of a core and account for it; returns whether it ran
+static inline int pt_core_call(struct pt_core *c, int i){
+	struct ptx *ptx = &c->threads[i] ;
+	#ifdef sched_stats
+	  uint64_t start = time_us_64() ;
+	#endif
+	c->current = i ;
+	c->executed = 0 ;
+	c->wake_time = 0 ;
+	// call thread function
+	(ptx->pf)(&ptx->pt) ;
+	#ifdef sched_stats
+	  pt_stats_update(&c->stats[i], start, c->executed) ;
+	#endif
+	return c->executed ;
+}
+
+// === sleep scheduler ====================================
+// Threads waiting on anything other than time (semaphores, the uart) are
+// still polled, at least every PT_POLL_usec while the core is idle
+#define PT_POLL_usec 1000
+
+#define pt_ready_test(q,i)  ((q)->ready[(i) >> 5] & (1u << ((i) & 31)))
+#define pt_ready_set(q,i)   ((q)->ready[(i) >> 5] |= 1u << ((i) & 31))
+#define pt_ready_clear(q,i) ((q)->ready[(i) >> 5] &= ~(1u << ((i) & 31)))
+
+static void pt_heap_push(struct ptx *list, struct pt_sleep_queue *q, int t){
+	int i = q->n++ ;
+	while (i > 0) {
+		int parent = (i - 1) / 2 ;
+		if (list[q->heap[parent]].wake <= list[t].wake) break ;
+		q->heap[i] = q->heap[parent] ;
+		i = parent ;
+	}
+	q->heap[i] = t ;
+}
+
+static int pt_heap_pop(struct ptx *list, struct pt_sleep_queue *q){
+	int top = q->heap[0] ;
+	int last = q->heap[--q->n] ;
+	int i = 0 ;
+	while (1) {
+		int child = 2 * i + 1 ;
+		if (child >= q->n) break ;
+		if (child + 1 < q->n && list[q->heap[child + 1]].wake < list[q->heap[child]].wake) child++ ;
+		if (list[last].wake <= list[q->heap[child]].wake) break ;
+		q->heap[i] = q->heap[child] ;
+		i = child ;
+	}
+	q->heap[i] = last ;
+	return top ;
+}
+
+// call thread i; if it went to sleep, queue it. Returns whether it ran.
+static int pt_sleep_call(struct pt_core *c, int i){
+	struct ptx *ptx = &c->threads[i] ;
+	int ran = pt_core_call(c, i) ;
+	if (c->wake_time) {
+		ptx->wake = c->wake_time ;
+		ptx->deadline = c->wake_time ;
+		if (ptx->period) ptx->deadline += ptx->rel_deadline ;
+		pt_heap_push(c->threads, &c->sleepers, i) ;
+	}
+	return ran ;
+}
+
+// poll the threads that are not sleeping; if none of them (nor anything
+// else in this pass) did anything, wait for the next wake time
+static void pt_poll_or_idle(struct pt_core *c, int ran){
+	struct pt_sleep_queue *q = &c->sleepers ;
+	int polled = 0, i ;
+	uint64_t now, until ;
+
+	for (i=0; i<c->task_count; i++) {
+		if (c->threads[i].wake == 0 && !pt_ready_test(q, i)) {
+			polled++ ;
+			ran |= pt_sleep_call(c, i) ;
+		}
+	}
+	if (ran) return ;
+
+	until = q->n ? c->threads[q->heap[0]].wake : UINT64_MAX ;
+	now = time_us_64() ;
+	if (polled && until > now + PT_POLL_usec) until = now + PT_POLL_usec ;
+	// any interrupt or __sev() from the other core ends the wait early,
+	// which just costs an extra pass
+	if (until > now) best_effort_wfe_or_timeout(from_us_since_boot(until)) ;
+}
+
+// one pass: threads that were due at the start of the pass, in wake
+// order, then the polled threads. A thread that yields with no delay is
+// due again at once, so each thread runs at most once per pass.
+static void pt_sleep_pass(struct pt_core *c){
+	struct pt_sleep_queue *q = &c->sleepers ;
+	int ran = 0, woken = 0, i ;
+	uint64_t now = time_us_64() ;
+
+	while (q->n && c->threads[q->heap[0]].wake <= now && woken++ < c->task_count) {
+		i = pt_heap_pop(c->threads, q) ;
+		c->threads[i].wake = 0 ;
+		ran |= pt_sleep_call(c, i) ;
+	}
+	pt_poll_or_idle(c, ran) ;
+}
+
+// one pass: run the due thread with the earliest deadline; the polled
+// threads only get a turn when no timed thread is due
+static void pt_edf_pass(struct pt_core *c){
+	struct pt_sleep_queue *q = &c->sleepers ;
+	int best = -1, i, w ;
+	uint32_t bits ;
+	uint64_t now = time_us_64() ;
+
+	while (q->n && c->threads[q->heap[0]].wake <= now) {
+		i = pt_heap_pop(c->threads, q) ;
+		c->threads[i].wake = 0 ;
+		pt_ready_set(q, i) ;
+	}
+	for (w=0; w<(PT_MAX_THREADS + 31) / 32; w++) {
+		for (bits = q->ready[w]; bits; bits &= bits - 1) {
+			i = w * 32 + __builtin_ctz(bits) ;
+			if (best < 0 || c->threads[i].deadline < c->threads[best].deadline) best = i ;
+		}
+	}
+	if (best >= 0) {
+		pt_ready_clear(q, best) ;
+		pt_sleep_call(c, best) ;
+		return ;
+	}
+	pt_poll_or_idle(c, 0) ;
+}
+
+// One scheduler pass over a core's threads in the current method. The
+// scheduler thread just repeats this; tools can call it directly.
+static void pt_sched_pass(struct pt_core *c){
+	int i ;
+	#ifdef sched_stats
+	 c->sched_count++ ;
+	#endif
+	switch (pt_sched_method) {
+	case SCHED_ROUND_ROBIN:
+		// test stupid round-robin 
+		// on all defined threads
+		for (i=0; i<c->task_count; i++) pt_core_call(c, i) ;
+		break ;
+	case SCHED_PRIORITY:
+		// the first thread that actually runs ends the pass, so
+		// earlier threads get the next look
+		for (i=0; i<c->task_count; i++) {
+			if (pt_core_call(c, i)) break ;
+		}
+		break ;
+	case SCHED_SLEEP:
+		pt_sleep_pass(c) ;
+		break ;
+	case SCHED_EDF:
+		pt_edf_pass(c) ;
+		break ;
+	}
+}
 
 static PT_THREAD (protothread_sched(struct pt *pt))
 {   
     PT_BEGIN(pt);
-    static int i, rate;
-    
-    if (pt_sched_method==SCHED_ROUND_ROBIN){
-        while(1) {
-          // test stupid round-robin 
-          // on all defined threads
-          struct ptx *ptx = &pt_thread_list[0];
-          // step thru all defined threads
-          // -- loop can have more than one initialization or increment/decrement, 
-          // -- separated using comma operator. But it can have only one condition.
-          for (i=0; i<pt_task_count; i++, ptx++ ){
-              // call thread function
-              (pt_thread_list[i].pf)(&ptx->pt); 
-          }
-          // Never yields! 
-          // NEVER exit while!
-        } // END WHILE(1)
-    } //end if (pt_sched_method==RR)     
-    //  
-    if (pt_sched_method==SCHED_PRIORITY){
-        while(1) {
-          // test stupid round-robin 
-          // on all defined threads
-          struct ptx *ptx = &pt_thread_list[0];
-
-          #ifdef sched_stats
-           sched_count++ ;
-          #endif
-
-          // step thru all defined threads
-          // -- loop can have more than one initialization or increment/decrement, 
-          // -- separated using comma operator. But it can have only one condition.
-          for (i=0; i<pt_task_count; i++, ptx++ ){
-              // zero execute flag
-              pt_executed = 0;
-              thread_time = time_us_64();
-              // call thread function
-              (pt_thread_list[i].pf)(&ptx->pt); 
-              // if there was execution, then restart execution list
-              if (pt_executed==1){
-                #ifdef sched_stats
-                  sched_thread_stats[i]++ ;
-                  sched_thread_time[i] += (time_us_64()-thread_time);
-                #endif
-                break ;
-              }
-          }
-          // Never yields! 
-          // NEVER exit while!
-        } // END WHILE(1)
-    } //end if (pt_sched_method==priority) 
-    
+    while(1) {
+      pt_sched_pass(pt_this_core()) ;
+      // Never yields! 
+      // NEVER exit while!
+    } // END WHILE(1)
     PT_END(pt);
 } // scheduler thread
 
-// ================================================
-// === second core scheduler
-static PT_THREAD (protothread_sched1(struct pt *pt))
-{   
-    PT_BEGIN(pt);
-    
-    static int i, rate;
-    
-    if (pt_sched_method==SCHED_ROUND_ROBIN){
-        while(1) {
-          // test stupid round-robin 
-          // on all defined threads
-          struct ptx *ptx = &pt_thread_list1[0];
-          // step thru all defined threads
-          // -- loop can have more than one initialization or increment/decrement, 
-          // -- separated using comma operator. But it can have only one condition.
-          for (i=0; i<pt_task_count1; i++, ptx++ ){
-              // call thread function
-              (pt_thread_list1[i].pf)(&ptx->pt); 
-          }
-          // Never yields! 
-          // NEVER exit while!
-        } // END WHILE(1)
-    } // end if(pt_sched_method==SCHED_ROUND_ROBIN)    
-    //
-    if (pt_sched_method==SCHED_PRIORITY){
-        while(1) {
-          // test stupid round-robin 
-          // on all defined threads
-          struct ptx *ptx = &pt_thread_list1[0];
-
-          #ifdef sched_stats
-           sched_count1++ ;
-          #endif
-
-          // step thru all defined threads
-          // -- loop can have more than one initialization or increment/decrement, 
-          // -- separated using comma operator. But it can have only one condition.
-          for (i=0; i<pt_task_count1; i++, ptx++ ){
-              // zero execute flag
-              pt_executed1 = 0;
-              thread_time1 = time_us_64();
-              // call thread function
-              (pt_thread_list1[i].pf)(&ptx->pt); 
-              // if there was execution, then restart execution list
-              if (pt_executed1==1){
-                #ifdef sched_stats
-                  sched_thread_stats1[i]++ ;
-                  sched_thread_time1[i] += (time_us_64()-thread_time1);
-                #endif
-                break ;
-              }
-          }
-          // Never yields! 
-          // NEVER exit while!
-        } // END WHILE(1)
-    } //end if (pt_sched_method==priority)   
-     
-    PT_END(pt);
-} // scheduler1 thread
-
 // ========================================================
 // === package the schedulers =============================
+// (the same scheduler runs on either core, on that core's threads)
 #define pt_schedule_start do{\
-  if(get_core_num()==1){ \
-    PT_INIT(&pt_sched1) ; \
-    PT_SCHEDULE(protothread_sched1(&pt_sched1));\
-  }  else {\
-    PT_INIT(&pt_sched) ;\
-    PT_SCHEDULE(protothread_sched(&pt_sched));\
-  }\
+    PT_INIT(&pt_this_core()->sched) ;\
+    PT_SCHEDULE(protothread_sched(&pt_this_core()->sched));\
 } while(0) 
 
 // === package the add thread ==========================
 #define pt_add_thread(thread_name) do{\
-  if(get_core_num()==1){ \
-    pt_add1(thread_name);\
-  }  else {\
-    pt_add(thread_name);\
-  }\
+  pt_core_add(pt_this_core(), thread_name, #thread_name);\
 } while(0) 
 
+// === periodic threads ================================
+// A periodic thread ends each period with PT_YIELD_PERIOD() instead of
+// working out its own spare time. Releases stay on a fixed grid of
+// period_us, so a slow frame does not push the later ones back, and a
+// period whose work ends after release+deadline_us counts as a miss.
+#define pt_add_thread_periodic(thread_name, period_us, deadline_us) do{\
+  struct pt_core *pt_c = pt_this_core();\
+  int pt_n = pt_core_add(pt_c, thread_name, #thread_name);\
+  if (pt_n >= 0) {\
+    pt_c->threads[pt_n].period = period_us;\
+    pt_c->threads[pt_n].rel_deadline = deadline_us;\
+  }\
+} while(0)
+
+static struct ptx *pt_self(void){
+	struct pt_core *c = pt_this_core() ;
+	return &c->threads[c->current] ;
+}
+
+// next release of the calling thread
+static uint64_t pt_period_next(void){
+	struct pt_core *c = pt_this_core() ;
+	struct ptx *self = &c->threads[c->current] ;
+	uint64_t now = time_us_64() ;
+	if (self->period == 0) return now ;
+	if (self->release == 0) {
+		// first period, or restarted: start the grid here
+		self->release = now + self->period ;
+		return self->release ;
+	}
+	if (now > self->release + self->rel_deadline) {
+		c->stats[c->current].misses++ ;
+	}
+	self->release += self->period ;
+	// more than a period behind: drop the lost releases rather than
+	// running them back to back
+	if (now > self->release + self->period) {
+		self->release += ((now - self->release) / self->period) * self->period ;
+	}
+	return self->release ;
+}
+
+#define PT_YIELD_PERIOD() do{ \
+    static uint64_t pt_release ;\
+    pt_release = pt_period_next() ;\
+    PT_SET_WAKE(pt_release) ;\
+    PT_YIELD_UNTIL(pt, (time_us_64() >= pt_release)) ;\
+} while(0)
+
+// for a thread that deliberately held up its period (e.g. a long pause):
+// restart the grid at the next PT_YIELD_PERIOD without counting a miss
+#define PT_PERIOD_RESTART() do{ pt_self()->release = 0 ; } while(0)
+
 // === serial input thread ================================
 // serial buffers
 #define pt_buffer_size 100
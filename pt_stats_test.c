@@ -0,0 +1,196 @@
+/**
+ * Scheduler telemetry test (host build only)
+ *
+ * Runs a busy thread and a gated thread on both cores' schedulers, under
+ * round-robin and priority scheduling, and checks the stats kept by the
+ * scheduler against what the threads themselves counted: runs and polls
+ * add up to the calls, run times cover the work done, the intervals
+ * between run starts add up to the span of the runs, forced frame
+ * overruns are counted, and pt_stats_reset() clears it all.
+ *
+ * Build with the SDK host platform:
+ *   cmake -S . -B build-host -DPICO_PLATFORM=host && cmake --build build-host
+ *   ctest --test-dir build-host
+ *
+ * Usage: pt_stats_test [passes per run, default 2000]
+ */
+#include "hardware/sync.h"
+#include "hardware/uart.h"
+#include "pico/multicore.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Both cores' schedulers are driven from this one thread, so the macros
+// look up the core being tested rather than the one running
+static int test_core;
+#define PT_CORE_NUM() test_core
+// protothreads header
+#include "pt_cornell_rp2040_v1_3.h"
+
+#define BUSY_US 50       // work done by the busy thread in each run
+#define OVERRUN_EVERY 4  // busy thread runs per forced overrun
+
+enum { GATED, BUSY, THREADS }; // in the order they are added
+
+// What the threads saw, per core
+typedef struct {
+  uint32_t calls; // times the scheduler called it
+  uint32_t runs;  // times it got past its wait
+  uint32_t overruns;
+  uint64_t first_start, last_start; // time_us_64() at its first/last run
+} Seen;
+
+static Seen seen[2][THREADS];
+static bool gate[2];
+static int failures;
+
+static void note_run(Seen *s) {
+  uint64_t now = time_us_64();
+  if (!s->runs) {
+    s->first_start = now;
+  }
+  s->last_start = now;
+  s->runs++;
+}
+
+static PT_THREAD(protothread_busy(struct pt *pt)) {
+  Seen *s = &seen[test_core][BUSY];
+  s->calls++;
+  PT_BEGIN(pt);
+  while (1) {
+    note_run(s);
+    uint64_t until = time_us_64() + BUSY_US;
+    while (time_us_64() < until) {
+    }
+    if (s->runs % OVERRUN_EVERY == 0) {
+      PT_FRAME_OVERRUN();
+      s->overruns++;
+    }
+    PT_YIELD(pt);
+  }
+  PT_END(pt);
+}
+
+static PT_THREAD(protothread_gated(struct pt *pt)) {
+  Seen *s = &seen[test_core][GATED];
+  s->calls++;
+  PT_BEGIN(pt);
+  while (1) {
+    note_run(s);
+    PT_YIELD_UNTIL(pt, gate[test_core]);
+  }
+  PT_END(pt);
+}
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("  FAIL %s: ", #cond);                                            \
+      printf(__VA_ARGS__);                                                     \
+      printf("\n");                                                            \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static void check_thread(const char *method, int core, int t,
+                         uint64_t begin, uint64_t end) {
+  const struct pt_stats *s = &pt_cores[core].stats[t];
+  const Seen *v = &seen[core][t];
+  const char *name = pt_cores[core].threads[t].name;
+
+  CHECK(s->runs == v->runs, "%s core %d %s: %u runs, thread saw %u", method,
+        core, name, s->runs, v->runs);
+  CHECK(s->runs + s->polls == v->calls, "%s core %d %s: %u + %u != %u calls",
+        method, core, name, s->runs, s->polls, v->calls);
+  CHECK(s->overruns == v->overruns, "%s core %d %s: %u overruns, forced %u",
+        method, core, name, s->overruns, v->overruns);
+  CHECK(s->max_us <= s->total_us && s->total_us <= end - begin,
+        "%s core %d %s: max %u, total %llu, elapsed %llu", method, core, name,
+        s->max_us, (unsigned long long)s->total_us,
+        (unsigned long long)(end - begin));
+  if (t == BUSY) {
+    CHECK(s->total_us >= (uint64_t)v->runs * BUSY_US && s->max_us >= BUSY_US,
+          "%s core %d %s: %llu us in %u runs of %d us", method, core, name,
+          (unsigned long long)s->total_us, v->runs, BUSY_US);
+  }
+
+  // Intervals between run starts telescope to last start - first start.
+  // The scheduler's first start is after begin and no later than the
+  // thread's own stamp.
+  if (s->runs > 1) {
+    CHECK(s->total_gap_us <= s->last_run - begin &&
+              s->total_gap_us >= s->last_run - v->first_start,
+          "%s core %d %s: gaps %llu, last start %llu, first %llu..%llu",
+          method, core, name, (unsigned long long)s->total_gap_us,
+          (unsigned long long)s->last_run, (unsigned long long)begin,
+          (unsigned long long)v->first_start);
+    CHECK(s->max_gap_us <= s->total_gap_us &&
+              (uint64_t)s->max_gap_us * (s->runs - 1) >= s->total_gap_us,
+          "%s core %d %s: max gap %u of %llu over %u intervals", method, core,
+          name, s->max_gap_us, (unsigned long long)s->total_gap_us,
+          s->runs - 1);
+    CHECK(s->last_run >= v->first_start && s->last_run <= v->last_start,
+          "%s core %d %s: last run %llu outside %llu..%llu", method, core,
+          name, (unsigned long long)s->last_run,
+          (unsigned long long)v->first_start,
+          (unsigned long long)v->last_start);
+  }
+}
+
+static void run(const char *name, int method, int passes) {
+  printf("%s\n", name);
+  pt_sched_method = method;
+  memset(seen, 0, sizeof(seen));
+  for (int core = 0; core < 2; core++) {
+    pt_core_reset(&pt_cores[core]);
+    // The gated thread goes first, so under the priority scheduler the
+    // busy one only gets the passes in which the gate is shut
+    pt_core_add(&pt_cores[core], protothread_gated, "protothread_gated");
+    pt_core_add(&pt_cores[core], protothread_busy, "protothread_busy");
+  }
+
+  uint64_t begin = time_us_64();
+  for (int i = 0; i < passes; i++) {
+    for (test_core = 0; test_core < 2; test_core++) {
+      // Open the gate on a core-dependent pattern, so the cores differ
+      gate[test_core] = i % (3 + test_core) == 0;
+      pt_sched_pass(&pt_cores[test_core]);
+    }
+  }
+  uint64_t end = time_us_64();
+
+  for (int core = 0; core < 2; core++) {
+    CHECK(pt_cores[core].sched_count == passes, "core %d: %d passes of %d",
+          core, pt_cores[core].sched_count, passes);
+    for (int t = 0; t < THREADS; t++) {
+      char line[140];
+      pt_stats_format(line, sizeof(line), core, t);
+      printf("  %s", line);
+      check_thread(name, core, t, begin, end);
+    }
+    CHECK(seen[core][GATED].calls > seen[core][GATED].runs,
+          "core %d: the gated thread was never polled", core);
+    CHECK(seen[core][BUSY].overruns > 0, "core %d: no overruns forced", core);
+  }
+
+  pt_stats_reset();
+  static const struct pt_stats zero;
+  for (int core = 0; core < 2; core++) {
+    CHECK(pt_cores[core].sched_count == 0, "core %d: passes not reset", core);
+    for (int t = 0; t < PT_MAX_THREADS; t++) {
+      CHECK(memcmp(&pt_cores[core].stats[t], &zero, sizeof(zero)) == 0,
+            "core %d thread %d: stats not reset", core, t);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  int passes = argc > 1 ? atoi(argv[1]) : 2000;
+  printf(PT_STATS_HEADER);
+  run("round-robin", SCHED_ROUND_ROBIN, passes);
+  run("priority", SCHED_PRIORITY, passes);
+  printf("%s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,295 @@
+#include "rle.h"
+#include <string.h>
+
+#if PICO_ON_DEVICE
+#include "hardware/dma.h"
+
+// Runs at least this long are handed to DMA, the rest are memset
+#define RLE_DMA_MIN 64
+
+static int fill_chan = -1;
+static uint32_t fill_word; // read by the DMA; only changed while it is idle
+
+static void fill_wait(void) {
+  if (fill_chan >= 0) {
+    dma_channel_wait_for_finish_blocking(fill_chan);
+  }
+}
+
+// Fill n bytes with value: the unaligned ends by CPU, the aligned middle by
+// DMA, word at a time from a fixed source. The DMA may still be running on
+// return.
+static void fill_run(uint8_t *dst, uint8_t value, int n) {
+  if (n < RLE_DMA_MIN) {
+    memset(dst, value, n);
+    return;
+  }
+  if (fill_chan < 0) {
+    fill_chan = dma_claim_unused_channel(true);
+  }
+  while ((uintptr_t)dst & 3) {
+    *dst++ = value;
+    n--;
+  }
+  int words = n >> 2;
+  memset(dst + words * 4, value, n & 3);
+
+  fill_wait();
+  fill_word = value * 0x01010101u;
+  dma_channel_config c = dma_channel_get_default_config(fill_chan);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+  channel_config_set_read_increment(&c, false);
+  channel_config_set_write_increment(&c, true);
+  dma_channel_configure(fill_chan, &c, dst, &fill_word, words, true);
+}
+#else
+static void fill_wait(void) {}
+
+static void fill_run(uint8_t *dst, uint8_t value, int n) {
+  memset(dst, value, n);
+}
+#endif
+
+// Send the pending literal
+static bool flush_literal(RleEncoder *e, uint8_t *dst, int cap, int *out) {
+  if (e->lit_len == 0) {
+    return true;
+  }
+  if (*out + 1 + e->lit_len > cap) {
+    return false;
+  }
+  dst[(*out)++] = e->lit_len - 1;
+  memcpy(&dst[*out], e->lit, e->lit_len);
+  *out += e->lit_len;
+  e->lit_len = 0;
+  return true;
+}
+
+// Send the pending repeat as a run if it is long enough, otherwise add it
+// to the literal
+static bool settle_run(RleEncoder *e, uint8_t *dst, int cap, int *out) {
+  if (e->run_len >= 3) {
+    int extra = e->run_len - 3;
+    if (!flush_literal(e, dst, cap, out) ||
+        *out + (extra >= 0x7f ? 4 : 2) > cap) {
+      return false;
+    }
+    if (extra >= 0x7f) {
+      dst[(*out)++] = 0xff;
+      dst[(*out)++] = (extra - 0x7f) & 0xff;
+      dst[(*out)++] = (extra - 0x7f) >> 8;
+    } else {
+      dst[(*out)++] = 0x80 | extra;
+    }
+    dst[(*out)++] = e->run_value;
+  } else {
+    for (int i = 0; i < e->run_len; i++) {
+      if (e->lit_len == 128 && !flush_literal(e, dst, cap, out)) {
+        return false;
+      }
+      e->lit[e->lit_len++] = e->run_value;
+    }
+  }
+  e->run_len = 0;
+  return true;
+}
+
+void rle_encoder_init(RleEncoder *e) {
+  e->lit_len = 0;
+  e->run_len = 0;
+}
+
+int rle_encoder_write(RleEncoder *e, const uint8_t *src, const uint8_t *prev,
+                      int len, uint8_t *dst, int cap) {
+  int out = 0;
+  for (int i = 0; i < len; i++) {
+    uint8_t b = prev ? src[i] ^ prev[i] : src[i];
+    if (e->run_len && b == e->run_value && e->run_len < RLE_RUN_MAX) {
+      e->run_len++;
+      continue;
+    }
+    if (!settle_run(e, dst, cap, &out)) {
+      return -1;
+    }
+    e->run_value = b;
+    e->run_len = 1;
+  }
+  return out;
+}
+
+int rle_encoder_finish(RleEncoder *e, uint8_t *dst, int cap) {
+  int out = 0;
+  if (!settle_run(e, dst, cap, &out) || !flush_literal(e, dst, cap, &out)) {
+    return -1;
+  }
+  return out;
+}
+
+int rle_encode(const uint8_t *src, int len, uint8_t *dst, int cap) {
+  RleEncoder e;
+  rle_encoder_init(&e);
+  int out = rle_encoder_write(&e, src, NULL, len, dst, cap);
+  if (out < 0) {
+    return -1;
+  }
+  int tail = rle_encoder_finish(&e, &dst[out], cap - out);
+  return tail < 0 ? -1 : out + tail;
+}
+
+int rle_decode(const uint8_t *src, int len, uint8_t *dst, int cap) {
+  int in = 0, out = 0;
+  while (in < len) {
+    uint8_t c = src[in++];
+    if (c < 0x80) {
+      int n = c + 1;
+      if (in + n > len || out + n > cap) {
+        out = -1;
+        break;
+      }
+      memcpy(&dst[out], &src[in], n);
+      in += n;
+      out += n;
+      continue;
+    }
+    int n = (c & 0x7f) + 3;
+    if ((c & 0x7f) == 0x7f) {
+      if (in + 2 > len) {
+        out = -1;
+        break;
+      }
+      n += src[in] | src[in + 1] << 8;
+      in += 2;
+    }
+    if (in + 1 > len || out + n > cap) {
+      out = -1;
+      break;
+    }
+    fill_run(&dst[out], src[in++], n);
+    out += n;
+  }
+  fill_wait();
+  return out;
+}
+
+// Decoder states: what the next stream byte is
+enum {
+  DEC_CONTROL,
+  DEC_EXT_LO, // low byte of a long run's count
+  DEC_EXT_HI,
+  DEC_VALUE,   // a run's value
+  DEC_LITERAL, // literal bytes, left of them to go
+  DEC_ERROR,
+};
+
+void rle_decoder_init(RleDecoder *d, uint8_t *dst, int row_bytes, int stride,
+                      int rows, bool delta) {
+  d->dst = dst;
+  d->row_bytes = row_bytes;
+  d->stride = stride;
+  d->rows = rows;
+  d->delta = delta;
+  d->pos = 0;
+  d->state = DEC_CONTROL;
+  d->left = 0;
+}
+
+// Where the next output byte goes, and how much of its row is left
+static uint8_t *decoder_out(const RleDecoder *d, int *room) {
+  int row = d->pos / d->row_bytes, col = d->pos % d->row_bytes;
+  *room = d->row_bytes - col;
+  return &d->dst[row * d->stride + col];
+}
+
+static void decoder_put(RleDecoder *d, const uint8_t *src, int n) {
+  while (n > 0) {
+    int room;
+    uint8_t *p = decoder_out(d, &room);
+    int k = n < room ? n : room;
+    if (d->delta) {
+      for (int i = 0; i < k; i++) {
+        p[i] ^= src[i];
+      }
+    } else {
+      memcpy(p, src, k);
+    }
+    src += k;
+    n -= k;
+    d->pos += k;
+  }
+}
+
+static void decoder_fill(RleDecoder *d, uint8_t value, int n) {
+  if (d->delta && value == 0) {
+    d->pos += n; // unchanged
+    return;
+  }
+  while (n > 0) {
+    int room;
+    uint8_t *p = decoder_out(d, &room);
+    int k = n < room ? n : room;
+    if (d->delta) {
+      for (int i = 0; i < k; i++) {
+        p[i] ^= value;
+      }
+    } else {
+      memset(p, value, k);
+    }
+    n -= k;
+    d->pos += k;
+  }
+}
+
+int rle_decoder_write(RleDecoder *d, const uint8_t *src, int len) {
+  int total = d->row_bytes * d->rows;
+  int in = 0;
+  while (in < len && d->state != DEC_ERROR) {
+    switch (d->state) {
+    case DEC_CONTROL:
+      d->control = src[in++];
+      if (d->control < 0x80) {
+        d->left = d->control + 1;
+        d->state = DEC_LITERAL;
+        if (d->pos + d->left > total) {
+          d->state = DEC_ERROR;
+        }
+      } else {
+        d->left = (d->control & 0x7f) + 3;
+        d->state = (d->control & 0x7f) == 0x7f ? DEC_EXT_LO : DEC_VALUE;
+      }
+      break;
+    case DEC_EXT_LO:
+      d->left += src[in++];
+      d->state = DEC_EXT_HI;
+      break;
+    case DEC_EXT_HI:
+      d->left += src[in++] << 8;
+      d->state = DEC_VALUE;
+      break;
+    case DEC_VALUE:
+      d->value = src[in++];
+      if (d->pos + d->left > total) {
+        d->state = DEC_ERROR;
+        break;
+      }
+      decoder_fill(d, d->value, d->left);
+      d->left = 0;
+      d->state = DEC_CONTROL;
+      break;
+    case DEC_LITERAL: {
+      int n = len - in < d->left ? len - in : d->left;
+      decoder_put(d, &src[in], n);
+      in += n;
+      d->left -= n;
+      if (d->left == 0) {
+        d->state = DEC_CONTROL;
+      }
+      break;
+    }
+    }
+  }
+  return d->state == DEC_ERROR ? -1 : d->pos;
+}
+
+bool rle_decoder_done(const RleDecoder *d) {
+  return d->state == DEC_CONTROL && d->pos == d->row_bytes * d->rows;
+}
@@ -0,0 +1,78 @@
+#include "pico/stdlib.h"
+
+#ifndef RLE_H
+#define RLE_H
+
+// Byte-oriented run-length coding, meant for framebuffer images: a byte
+// holds two 4bpp pixels, so a run of one byte value is a run of one color
+// (or of a two-color dither).
+//
+// The stream is a sequence of tokens, each starting with a control byte c:
+//   c < 0x80    a literal: the next c + 1 bytes are copied (1..128)
+//   c >= 0x80   a run of one byte value, n = (c & 0x7f) + 3 bytes long;
+//               when c & 0x7f is 0x7f a 16-bit little-endian count follows
+//               and is added to n. The value byte comes last.
+// Runs shorter than 3 bytes are sent as literals.
+//
+// Delta streams code the XOR of an image with a reference (normally the
+// previous frame) in the same format. Unchanged bytes XOR to zero, so they
+// become long zero runs, and a delta decoder applies the stream to the
+// reference in place, skipping those runs without touching memory.
+
+#define RLE_RUN_MAX (0x7f + 3 + 0xffff)
+
+// Worst-case encoded size of len bytes (all literals)
+#define RLE_BOUND(len) ((len) + ((len) + 127) / 128)
+
+// Encode len bytes of src into dst. Returns the encoded size, or -1 if it
+// does not fit in cap bytes.
+int rle_encode(const uint8_t *src, int len, uint8_t *dst, int cap);
+
+// Decode len bytes of src into dst. Returns the decoded size, or -1 if the
+// stream is malformed or would overflow cap bytes. On the device, long runs
+// are filled by DMA while the CPU carries on with the rest of the stream.
+int rle_decode(const uint8_t *src, int len, uint8_t *dst, int cap);
+
+// Streaming encoder: the image goes in as any number of chunks (rows of a
+// region, say) and the tokens come out as they complete. A token may stay
+// pending across chunks; rle_encoder_finish() flushes it.
+typedef struct {
+  uint8_t lit[128]; // literal not yet sent
+  int lit_len;
+  uint8_t run_value; // run or short repeat not yet settled
+  int run_len;
+} RleEncoder;
+
+// Most bytes one rle_encoder_write() of len bytes, or a finish, can emit
+#define RLE_STREAM_BOUND(len) (RLE_BOUND((len) + 130) + 4)
+
+void rle_encoder_init(RleEncoder *e);
+// Code len bytes of src, or of src XOR prev when prev is not NULL, into
+// dst. Returns the bytes written, or -1 if they do not fit in cap (the
+// stream is then broken and must be restarted).
+int rle_encoder_write(RleEncoder *e, const uint8_t *src, const uint8_t *prev,
+                      int len, uint8_t *dst, int cap);
+// Flush the pending token; same return as rle_encoder_write()
+int rle_encoder_finish(RleEncoder *e, uint8_t *dst, int cap);
+
+// Streaming decoder into a rectangle of rows row_bytes long, stride bytes
+// apart (row_bytes == stride for a contiguous buffer). The stream may be
+// fed in pieces of any size, split anywhere.
+typedef struct {
+  uint8_t *dst;
+  int row_bytes, stride, rows;
+  bool delta; // XOR into dst instead of writing
+  int pos;    // bytes of the rectangle produced
+  uint8_t state, control, value;
+  int left; // bytes of the current token still to produce
+} RleDecoder;
+
+void rle_decoder_init(RleDecoder *d, uint8_t *dst, int row_bytes, int stride,
+                      int rows, bool delta);
+// Decode len bytes of the stream. Returns the bytes of the rectangle
+// produced so far, or -1 if the stream is malformed or overflows it.
+int rle_decoder_write(RleDecoder *d, const uint8_t *src, int len);
+// True once the rectangle is full and no token is part way through
+bool rle_decoder_done(const RleDecoder *d);
+
+#endif // RLE_H
@@ -0,0 +1,152 @@
+/**
+ * Frame codec benchmark (host build only)
+ *
+ * Captures frames of a game -- the baked starting screen with the grid,
+ * boids and cursor drawn over it by the same code as the device -- and
+ * times the run-length codec (rle.h) on them, whole frames and deltas
+ * against the previous frame. Reports throughput in MB/s of frame data
+ * and the compression ratio, and checks every frame decodes back exactly.
+ *
+ * Build with the SDK host platform:
+ *   cmake -S . -B build-host -DPICO_PLATFORM=host && cmake --build build-host
+ *
+ * Usage: rle_bench [options]
+ *   -n <frames>     frames to capture (default 32)
+ *   -t <ticks>      game ticks between frames (default 4, one tick per
+ *                   FRAMES_PER_TICK refreshes on the device)
+ *   -s <seed>       game seed (default 1)
+ *   -r <repeats>    passes over the frames per measurement (default 10)
+ */
+#include "boot_screen.h"
+#include "game_state.h"
+#include "grid_render.h"
+#include "rle.h"
+#include "task_pool.h"
+#include "vga16_graphics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAME_BYTES (VGA_STRIDE * VGA_HEIGHT)
+
+static GameState game_state;
+static uint8_t *frames;  // captured frames, FRAME_BYTES each
+static uint8_t *encoded; // each frame's stream, RLE_BOUND(FRAME_BYTES) each
+static int *encoded_size;
+static uint8_t decoded[FRAME_BYTES];
+
+static uint8_t *frame(int i) { return &frames[(size_t)i * FRAME_BYTES]; }
+static uint8_t *stream(int i) {
+  return &encoded[(size_t)i * RLE_BOUND(FRAME_BYTES)];
+}
+
+// Frame i whole, or against frame i - 1 in delta mode. Frame 0 is always
+// coded whole.
+static int encode_frame(int i, bool delta) {
+  RleEncoder e;
+  rle_encoder_init(&e);
+  const uint8_t *prev = delta && i > 0 ? frame(i - 1) : NULL;
+  int cap = RLE_BOUND(FRAME_BYTES);
+  int n = rle_encoder_write(&e, frame(i), prev, FRAME_BYTES, stream(i), cap);
+  int tail = rle_encoder_finish(&e, stream(i) + n, cap - n);
+  return n < 0 || tail < 0 ? -1 : n + tail;
+}
+
+// Decode frame i into decoded[], which holds frame i - 1 in delta mode
+static bool decode_frame(int i, bool delta) {
+  RleDecoder d;
+  rle_decoder_init(&d, decoded, FRAME_BYTES, FRAME_BYTES, 1, delta && i > 0);
+  return rle_decoder_write(&d, stream(i), encoded_size[i]) == FRAME_BYTES &&
+         rle_decoder_done(&d);
+}
+
+static void measure(const char *name, int count, int repeats, bool delta) {
+  uint64_t t0 = time_us_64();
+  long total = 0;
+  for (int r = 0; r < repeats; r++) {
+    total = 0;
+    for (int i = 0; i < count; i++) {
+      encoded_size[i] = encode_frame(i, delta);
+      total += encoded_size[i];
+    }
+  }
+  uint64_t t1 = time_us_64();
+  bool ok = true;
+  for (int r = 0; r < repeats; r++) {
+    for (int i = 0; i < count; i++) {
+      ok = decode_frame(i, delta) && ok;
+      ok = memcmp(decoded, frame(i), FRAME_BYTES) == 0 && ok;
+    }
+  }
+  uint64_t t2 = time_us_64();
+
+  double bytes = (double)FRAME_BYTES * count * repeats;
+  printf("  %-6s  encode %8.1f MB/s  decode %8.1f MB/s  %8ld bytes/frame"
+         "  ratio %7.1f:1%s\n",
+         name, t1 > t0 ? bytes / (t1 - t0) : 0.0,
+         t2 > t1 ? bytes / (t2 - t1) : 0.0, total / count,
+         total ? (double)FRAME_BYTES * count / total : 0.0,
+         ok ? "" : "  MISMATCH");
+  if (!ok) {
+    exit(1);
+  }
+}
+
+int main(int argc, char **argv) {
+  int count = 32, spacing = 4, repeats = 10;
+  uint32_t seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    const char *opt = argv[i];
+    const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+    if (val && strcmp(opt, "-n") == 0) {
+      count = atoi(val);
+    } else if (val && strcmp(opt, "-t") == 0) {
+      spacing = atoi(val);
+    } else if (val && strcmp(opt, "-s") == 0) {
+      seed = strtoul(val, NULL, 0);
+    } else if (val && strcmp(opt, "-r") == 0) {
+      repeats = atoi(val);
+    } else {
+      fprintf(stderr, "usage: %s [-n frames] [-t ticks] [-s seed] "
+                      "[-r repeats]\n", argv[0]);
+      return 1;
+    }
+    i++;
+  }
+  if (count < 1 || spacing < 1 || repeats < 1) {
+    fprintf(stderr, "%s: counts must be positive\n", argv[0]);
+    return 1;
+  }
+
+  frames = malloc((size_t)count * FRAME_BYTES);
+  encoded = malloc((size_t)count * RLE_BOUND(FRAME_BYTES));
+  encoded_size = malloc(count * sizeof(int));
+  if (!frames || !encoded || !encoded_size) {
+    fprintf(stderr, "%s: out of memory\n", argv[0]);
+    return 1;
+  }
+
+  // Play the game from its starting screen, capturing as it goes
+  task_pool_init();
+  game_state_init(&game_state, ROWS, COLS, seed);
+  game_state.play_state = PLAYING;
+  rle_decode(boot_screen_rle, sizeof(boot_screen_rle), vga_data_array,
+             FRAME_BYTES);
+  invalidate_grid();
+  for (int i = 0; i < count; i++) {
+    for (int t = 0; t < spacing; t++) {
+      game_state_update(&game_state);
+      game_state_update_progress(&game_state);
+      draw_grid(&game_state);
+      vga_draw_flush();
+    }
+    memcpy(frame(i), vga_data_array, FRAME_BYTES);
+  }
+
+  printf("%d frames, %d ticks apart, seed %u, %d repeats\n", count, spacing,
+         seed, repeats);
+  measure("whole", count, repeats, false);
+  measure("delta", count, repeats, true);
+  return 0;
+}
@@ -0,0 +1,24 @@
+#include "rng.h"
+
+void rng_seed(Rng *rng, uint32_t seed) {
+  // Run the seed through a finaliser (from MurmurHash3) so that nearby
+  // seeds start far apart; xorshift cannot leave the all-zero state
+  seed ^= seed >> 16;
+  seed *= 0x85EBCA6B;
+  seed ^= seed >> 13;
+  seed *= 0xC2B2AE35;
+  seed ^= seed >> 16;
+  rng->state = seed ? seed : 0x5D9EA;
+}
+
+// Generate a block of numbers with the state held in a register
+void rng_fill(Rng *rng, uint32_t *out, int count) {
+  uint32_t x = rng->state;
+  for (int i = 0; i < count; i++) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    out[i] = x;
+  }
+  rng->state = x;
+}
@@ -0,0 +1,26 @@
+#include "pico/stdlib.h"
+
+#ifndef RNG_H
+#define RNG_H
+
+// Small, fast pseudo-random generator (Marsaglia xorshift32) with explicit
+// state. Three shifts and three xors per number and no multiply, which
+// suits the M0+. Give each core its own Rng so the cores never share state
+// the way they share newlib's rand().
+typedef struct {
+  uint32_t state; // never zero
+} Rng;
+
+void rng_seed(Rng *rng, uint32_t seed);
+void rng_fill(Rng *rng, uint32_t *out, int count);
+
+static inline uint32_t rng_next(Rng *rng) {
+  uint32_t x = rng->state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  rng->state = x;
+  return x;
+}
+
+#endif // RNG_H
@@ -0,0 +1,57 @@
+#include "seed.h"
+#if PICO_ON_DEVICE
+#include "hardware/structs/rosc.h"
+#endif
+
+#ifdef GAME_SEED
+static bool seed_fixed = true;
+static uint32_t fixed_seed = GAME_SEED;
+#else
+static bool seed_fixed = false;
+static uint32_t fixed_seed = 0;
+#endif
+
+void seed_set_fixed(uint32_t seed) {
+  fixed_seed = seed;
+  seed_fixed = true;
+}
+
+void seed_clear_fixed(void) { seed_fixed = false; }
+
+bool seed_is_fixed(void) { return seed_fixed; }
+
+uint32_t seed_get(void) {
+  return seed_fixed ? fixed_seed : seed_from_entropy();
+}
+
+#if PICO_ON_DEVICE
+// One raw bit from the ring oscillator. Back-to-back reads are correlated,
+// so give the oscillator a few cycles between samples.
+static inline uint32_t rosc_bit(void) {
+  for (volatile int i = 0; i < 8; i++) {
+  }
+  return rosc_hw->randombit & 1;
+}
+
+uint32_t seed_from_entropy(void) {
+  uint32_t seed = 0;
+  int bits = 0;
+  // von Neumann debiasing: keep the first bit of each 01/10 pair and drop
+  // 00/11 pairs. The attempt cap keeps a stuck oscillator from hanging us.
+  for (int attempts = 0; bits < 32 && attempts < 1024; attempts++) {
+    uint32_t a = rosc_bit();
+    uint32_t b = rosc_bit();
+    if (a != b) {
+      seed = (seed << 1) | a;
+      bits++;
+    }
+  }
+  return seed ^ time_us_32();
+}
+#else
+uint32_t seed_from_entropy(void) {
+  uint64_t now = time_us_64();
+  uint32_t here = (uint32_t)(uintptr_t)&now; // varies with ASLR
+  return (uint32_t)now ^ (uint32_t)(now >> 32) ^ (here * 0x9E3779B9u);
+}
+#endif
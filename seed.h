@@ -0,0 +1,17 @@
+#include "pico/stdlib.h"
+
+#ifndef SEED_H
+#define SEED_H
+
+// Where game seeds come from. A fixed seed (GAME_SEED at build time, or
+// seed_set_fixed() at runtime) makes every run identical, which is what
+// benchmark and replay runs need. Otherwise seeds are gathered from the
+// ring oscillator's random bit on the RP2040; the host build stands in
+// with the clock.
+uint32_t seed_get(void);
+uint32_t seed_from_entropy(void);
+void seed_set_fixed(uint32_t seed);
+void seed_clear_fixed(void);
+bool seed_is_fixed(void);
+
+#endif // SEED_H
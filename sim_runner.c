@@ -0,0 +1,378 @@
+/**
+ * Headless simulation runner (host build only)
+ *
+ * Drives the game core -- game_state_init, game_state_update (cell refresh,
+ * boids, collisions), refinement and the progress bar -- for a fixed number
+ * of ticks with a fixed seed and scripted inputs, optionally rendering the
+ * grid into the (off-screen) frame buffer, and reports throughput. One tick
+ * is one pass of the frame loop in protothread_graphics.
+ *
+ * It can also replay an input log dumped from the device ("dump" on the
+ * serial console): the joystick and button are sampled at the device's
+ * thread periods against the logged input state, through the same input.c
+ * code, and the game starts at the first debounced press with the logged
+ * seed. Timing is the nominal tick period, so the replay follows the
+ * inputs exactly but not the device's frame-to-frame jitter.
+ *
+ * Build with the SDK host platform:
+ *   cmake -S . -B build-host -DPICO_PLATFORM=host && cmake --build build-host
+ *
+ * Usage: sim_runner [options]
+ *   -n <ticks>      ticks to run (default 10000)
+ *   -s <seed>       game seed (default 1)
+ *   -g <rows>x<cols> grid size (default 7x15)
+ *   -i <script>     scripted inputs, see below
+ *   -r <log>        replay a device input log (default ticks: its length)
+ *   -a              autoplay: press whenever a boid is on a bad number
+ *   -q              no rendering, simulation only
+ *   -j              run a second thread as core 1 for the task pool
+ *
+ * Script lines are "<tick> <command> [args]", run before that tick's update:
+ *   <tick> cursor <row> <col>   move the cursor to a cell
+ *   <tick> press                press the button (refine at the cursor)
+ *   <tick> auto on|off          switch autoplay
+ * Blank lines and lines starting with '#' are ignored.
+ */
+#include "game_state.h"
+#include "grid_render.h"
+#include "input.h"
+#include "task_pool.h"
+#include "vga16_graphics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SCRIPT_LINES 4096
+// One game tick of protothread_graphics, which waits FRAMES_PER_TICK
+// refreshes of the 60 Hz VGA frame clock (66.7 ms)
+#define TICK_US (FRAMES_PER_TICK * VGA_FRAME_US)
+
+typedef enum { CMD_CURSOR, CMD_PRESS, CMD_AUTO } CommandType;
+
+typedef struct {
+  long tick;
+  CommandType type;
+  int a, b;
+} Command;
+
+static Command script[MAX_SCRIPT_LINES];
+static int script_length;
+
+static GameState game_state;
+
+static InputEvent *replay;
+static int replay_length;
+static bool replay_has_seed;
+static uint32_t replay_seed;
+
+static int load_script(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    return -1;
+  }
+  char line[128];
+  int line_no = 0;
+  while (fgets(line, sizeof(line), f)) {
+    line_no++;
+    char name[16], arg[16];
+    long tick;
+    int a = 0, b = 0;
+    Command *cmd = &script[script_length];
+
+    if (line[0] == '#' || line[0] == '\n') {
+      continue;
+    }
+    if (script_length == MAX_SCRIPT_LINES) {
+      fprintf(stderr, "%s: more than %d commands\n", path, MAX_SCRIPT_LINES);
+      break;
+    }
+    int n = sscanf(line, "%ld %15s %d %d", &tick, name, &a, &b);
+    if (n >= 4 && strcmp(name, "cursor") == 0) {
+      cmd->type = CMD_CURSOR;
+    } else if (n >= 2 && strcmp(name, "press") == 0) {
+      cmd->type = CMD_PRESS;
+    } else if (sscanf(line, "%ld %15s %15s", &tick, name, arg) == 3 &&
+               strcmp(name, "auto") == 0) {
+      cmd->type = CMD_AUTO;
+      a = strcmp(arg, "on") == 0;
+    } else {
+      fprintf(stderr, "%s:%d: cannot parse: %s", path, line_no, line);
+      fclose(f);
+      return -1;
+    }
+    cmd->tick = tick;
+    cmd->a = a;
+    cmd->b = b;
+    script_length++;
+  }
+  fclose(f);
+  return 0;
+}
+
+// Log lines are "<t_us> <adc_x> <adc_y> <button>"; "# seed <n>" gives the
+// seed of the recorded game, "# input log: <n> events, <d> dropped" how
+// many of the oldest events the device's ring lost. Other '#' lines are
+// comments. A log with dropped events starts mid-game, so it is refused.
+static int load_replay(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    return -1;
+  }
+  char line[128];
+  int capacity = 0;
+  while (fgets(line, sizeof(line), f)) {
+    unsigned long t, x, y, button, dropped;
+    int events;
+    if (sscanf(line, "# input log: %d events, %lu dropped", &events,
+               &dropped) == 2 &&
+        dropped != 0) {
+      fprintf(stderr,
+              "%s: the device dropped the first %lu input events (it keeps "
+              "%d); the log does not start with the game and cannot be "
+              "replayed\n",
+              path, dropped, INPUT_LOG_SIZE);
+      fclose(f);
+      return -1;
+    }
+    if (sscanf(line, "# seed %lu", &t) == 1) {
+      replay_seed = t;
+      replay_has_seed = true;
+      continue;
+    }
+    if (sscanf(line, "%lu %lu %lu %lu", &t, &x, &y, &button) != 4) {
+      continue;
+    }
+    if (replay_length == capacity) {
+      capacity = capacity ? capacity * 2 : 256;
+      replay = realloc(replay, capacity * sizeof(InputEvent));
+    }
+    InputEvent *ev = &replay[replay_length++];
+    ev->t_us = t;
+    ev->adc_x = x;
+    ev->adc_y = y;
+    ev->button = button != 0;
+  }
+  fclose(f);
+  if (replay_length == 0) {
+    fprintf(stderr, "%s: no input events\n", path);
+    return -1;
+  }
+  // Times relative to the first event; unsigned so time_us_32 wrap is fine
+  uint32_t t0 = replay[0].t_us;
+  for (int i = 0; i < replay_length; i++) {
+    replay[i].t_us -= t0;
+  }
+  return 0;
+}
+
+// Logged input state at time t for a sampler whose position is *pos
+static const InputEvent *replay_at(int *pos, uint32_t t) {
+  while (*pos + 1 < replay_length && replay[*pos + 1].t_us <= t) {
+    (*pos)++;
+  }
+  return &replay[*pos];
+}
+
+static void set_cursor_cell(GameState *state, int row, int col) {
+  state->cursor.x = GRID_START_X + col * CELL_WIDTH;
+  state->cursor.y = GRID_START_Y + row * CELL_HEIGHT;
+}
+
+// Autoplay: put the cursor on the first bad number a boid is touching and
+// press, like a player who never misses
+static bool autoplay(GameState *state) {
+  GridIndex *index = &state->index;
+  for (int i = 0; i < index->touched_count; i++) {
+    int idx = index->touched_list[i];
+    Number *num = &state->cells[idx];
+    if (num_is_bad(num) && (num->bits & NUM_TOUCHED)) {
+      set_cursor_cell(state, idx / state->cols, idx % state->cols);
+      handle_cursor_refinement(state);
+      return true;
+    }
+  }
+  return false;
+}
+
+// FNV-1a over everything the simulation owns, to compare runs
+static uint32_t state_hash(GameState *state) {
+  uint32_t hash = 2166136261u;
+  const unsigned char *p = (const unsigned char *)state->cells;
+  for (size_t i = 0; i < state->rows * state->cols * sizeof(Number); i++) {
+    hash = (hash ^ p[i]) * 16777619u;
+  }
+  p = (const unsigned char *)state->boids;
+  for (size_t i = 0; i < sizeof(state->boids); i++) {
+    hash = (hash ^ p[i]) * 16777619u;
+  }
+  return hash;
+}
+
+int main(int argc, char **argv) {
+  long ticks = -1;
+  uint32_t seed = 1;
+  bool seed_given = false;
+  int rows = ROWS, cols = COLS;
+  bool render = true;
+  bool autoplay_on = false;
+  bool worker = false;
+
+  for (int i = 1; i < argc; i++) {
+    const char *opt = argv[i];
+    const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+    if (strcmp(opt, "-n") == 0 && val) {
+      ticks = atol(val);
+      i++;
+    } else if (strcmp(opt, "-s") == 0 && val) {
+      seed = strtoul(val, NULL, 0);
+      seed_given = true;
+      i++;
+    } else if (strcmp(opt, "-g") == 0 && val &&
+               sscanf(val, "%dx%d", &rows, &cols) == 2) {
+      i++;
+    } else if (strcmp(opt, "-i") == 0 && val) {
+      if (load_script(val) != 0) {
+        return 1;
+      }
+      i++;
+    } else if (strcmp(opt, "-r") == 0 && val) {
+      if (load_replay(val) != 0) {
+        return 1;
+      }
+      i++;
+    } else if (strcmp(opt, "-a") == 0) {
+      autoplay_on = true;
+    } else if (strcmp(opt, "-q") == 0) {
+      render = false;
+    } else if (strcmp(opt, "-j") == 0) {
+      worker = true;
+    } else {
+      fprintf(stderr, "usage: %s [-n ticks] [-s seed] [-g RxC] [-i script] "
+                      "[-r log] [-a] [-q] [-j]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if (replay_has_seed && !seed_given) {
+    seed = replay_seed;
+  }
+  if (ticks < 0) {
+    ticks = replay ? replay[replay_length - 1].t_us / TICK_US + 1 : 10000;
+  }
+
+  task_pool_init();
+  if (worker) {
+    task_pool_start_worker();
+  }
+
+  game_state_init(&game_state, rows, cols, seed);
+  // A replay waits on the start screen for its first press, like the device
+  game_state.play_state = replay ? START_SCREEN : PLAYING;
+  if (render) {
+    fillRect(0, 0, VGA_WIDTH, VGA_HEIGHT, BLACK);
+    invalidate_grid();
+  }
+
+  uint64_t sim_us = 0, render_us = 0;
+  long presses = 0;
+  int next_command = 0;
+  Debouncer debouncer = {0};
+  int joystick_pos = 0, button_pos = 0;
+  uint32_t next_joystick = 0, next_button = 0;
+
+  for (long tick = 0; tick < ticks; tick++) {
+    uint64_t t0 = time_us_64();
+    uint32_t now = tick * TICK_US;
+
+    // Input threads that would have run since the last frame
+    while (replay && (next_button <= now || next_joystick <= now)) {
+      if (next_button <= next_joystick) {
+        const InputEvent *ev = replay_at(&button_pos, next_button);
+        if (input_button(&debouncer, ev->button, next_button)) {
+          handle_cursor_refinement(&game_state);
+          presses++;
+          if (game_state.play_state == START_SCREEN) {
+            game_state_init(&game_state, rows, cols, seed);
+            game_state.play_state = PLAYING;
+            invalidate_grid();
+          }
+        }
+        next_button += INPUT_BUTTON_PERIOD_US;
+      } else {
+        const InputEvent *ev = replay_at(&joystick_pos, next_joystick);
+        static const int moves[][2] = {
+            [INPUT_RIGHT] = {1, 0},
+            [INPUT_LEFT] = {-1, 0},
+            [INPUT_DOWN] = {0, 1},
+            [INPUT_UP] = {0, -1},
+        };
+        InputDirection dir = input_joystick(ev->adc_x, ev->adc_y, next_joystick);
+        game_state_move_cursor(&game_state, moves[dir][0], moves[dir][1]);
+        next_joystick += INPUT_JOYSTICK_PERIOD_US;
+      }
+    }
+    if (game_state.play_state == START_SCREEN) {
+      continue;
+    }
+
+    // Inputs arrive between frames, as they do from the button thread
+    for (; next_command < script_length && script[next_command].tick <= tick;
+         next_command++) {
+      Command *cmd = &script[next_command];
+      switch (cmd->type) {
+      case CMD_CURSOR:
+        set_cursor_cell(&game_state, cmd->a, cmd->b);
+        break;
+      case CMD_PRESS:
+        handle_cursor_refinement(&game_state);
+        presses++;
+        break;
+      case CMD_AUTO:
+        autoplay_on = cmd->a;
+        break;
+      }
+    }
+    if (autoplay_on && autoplay(&game_state)) {
+      presses++;
+    }
+
+    game_state_update(&game_state);
+    game_state_update_progress(&game_state);
+    uint64_t t1 = time_us_64();
+    sim_us += t1 - t0;
+
+    if (render) {
+      draw_grid(&game_state);
+      vga_draw_flush();
+      render_us += time_us_64() - t1;
+    } else {
+      grid_clear_dirty(&game_state);
+    }
+  }
+
+  printf("%ld ticks, %dx%d grid, seed %u, rendering %s\n", ticks,
+         game_state.rows, game_state.cols, seed, render ? "on" : "off");
+  printf("  simulation  %10.3f ms  %12.0f ticks/s  %8.3f us/tick\n",
+         sim_us / 1000.0, sim_us ? ticks * 1e6 / sim_us : 0.0,
+         ticks ? (double)sim_us / ticks : 0.0);
+  if (render) {
+    printf("  rendering   %10.3f ms  %12.0f ticks/s  %8.3f us/tick\n",
+           render_us / 1000.0, render_us ? ticks * 1e6 / render_us : 0.0,
+           ticks ? (double)render_us / ticks : 0.0);
+  }
+  printf("  presses %ld, bad numbers %d in %d groups, progress %d%%%s\n",
+         presses, game_state.total_bad_numbers, game_state.groups.group_count,
+         game_state.progress_bar.current_progress,
+         game_state.play_state == GAME_WON ? " (won)" : "");
+  if (worker) {
+    TaskPoolStats stats;
+    task_pool_stop_worker();
+    task_pool_get_stats(&stats);
+    printf("  tasks run %u + %u, stolen %u + %u\n", stats.tasks_run[0],
+           stats.tasks_run[1], stats.steals[0], stats.steals[1]);
+  }
+  printf("  state hash 0x%08x\n", state_hash(&game_state));
+  return 0;
+}
@@ -0,0 +1,295 @@
+#include "sprite.h"
+#include "vga16_graphics.h"
+#include <string.h>
+
+typedef struct {
+  const SpriteImage *image;
+  uint8_t z;
+  bool visible;
+  short x, y;
+  // Position the latest queued show draws at
+  bool show_visible;
+  short show_x, show_y;
+  // Where the sprite is on screen, while drawn
+  bool drawn;
+  short drawn_x, drawn_y;
+  uint8_t *save; // h rows of w / 2 + 1 bytes
+} Sprite;
+
+// Scanout mode: sprites as of the latest show, sorted by top edge, for the
+// line compositor. Two copies; the compositor switches to a newly
+// published one at the top of a frame.
+typedef struct {
+  const SpriteImage *image;
+  short x, y;
+  uint8_t rank; // place in the z order
+} ScanSprite;
+
+typedef struct {
+  int count;
+  ScanSprite sprites[SPRITE_MAX];
+} ScanFrame;
+
+static bool scanout;
+static ScanFrame scan_frames[2];
+static volatile int scan_live;
+static volatile int scan_pending = -1;
+static volatile uint32_t line_overflow;
+
+static Sprite sprites[SPRITE_MAX];
+static uint8_t order[SPRITE_MAX]; // sprite ids by ascending z
+static int sprite_count;
+static uint8_t save_pool[SPRITE_SAVE_BYTES];
+static int save_used;
+
+// A sprite at (x, y) clipped to the screen; false if nothing is left
+typedef struct {
+  short x0, y0, x1, y1;
+} Clip;
+
+static bool clip_sprite(const Sprite *s, short x, short y, Clip *c) {
+  c->x0 = x < 0 ? 0 : x;
+  c->y0 = y < 0 ? 0 : y;
+  c->x1 = x + s->image->w > VGA_WIDTH ? VGA_WIDTH : x + s->image->w;
+  c->y1 = y + s->image->h > VGA_HEIGHT ? VGA_HEIGHT : y + s->image->h;
+  return c->x0 < c->x1 && c->y0 < c->y1;
+}
+
+// Whole framebuffer bytes are saved and restored, which may include one
+// pixel either side of the sprite
+static void save_under(Sprite *s, const Clip *c) {
+  int stride = s->image->w / 2 + 1;
+  int bytes = ((c->x1 - 1) >> 1) - (c->x0 >> 1) + 1;
+  for (int y = c->y0; y < c->y1; y++) {
+    memcpy(&s->save[(y - c->y0) * stride],
+           &vga_data_array[y * VGA_STRIDE + (c->x0 >> 1)], bytes);
+  }
+}
+
+static void restore_under(Sprite *s, const Clip *c) {
+  int stride = s->image->w / 2 + 1;
+  int bytes = ((c->x1 - 1) >> 1) - (c->x0 >> 1) + 1;
+  for (int y = c->y0; y < c->y1; y++) {
+    memcpy(&vga_data_array[y * VGA_STRIDE + (c->x0 >> 1)],
+           &s->save[(y - c->y0) * stride], bytes);
+  }
+}
+
+// Draw columns [x0, x1) of one image row into a line of pixels, the image
+// starting at x
+static void __not_in_flash_func(draw_sprite_row)(unsigned char *row,
+                                                 const SpriteImage *image,
+                                                 int image_row, short x,
+                                                 short x0, short x1) {
+  const uint8_t *src = &image->pixels[image_row * ((image->w + 1) / 2)];
+  for (int px = x0; px < x1; px++) {
+    int col = px - x;
+    uint8_t color = (src[col >> 1] >> ((col & 1) * 4)) & 0x0f;
+    if (color == image->key) {
+      continue;
+    }
+    if (px & 1) {
+      row[px >> 1] = (row[px >> 1] & 0x0f) | (color << 4);
+    } else {
+      row[px >> 1] = (row[px >> 1] & 0xf0) | color;
+    }
+  }
+}
+
+static void draw_sprite(const Sprite *s, short x, short y, const Clip *c) {
+  for (int py = c->y0; py < c->y1; py++) {
+    draw_sprite_row(&vga_data_array[py * VGA_STRIDE], s->image, py - y, x,
+                    c->x0, c->x1);
+  }
+}
+
+int sprite_add(const SpriteImage *image, int z) {
+  int save_bytes = image->h * (image->w / 2 + 1);
+  if (sprite_count == SPRITE_MAX ||
+      save_used + save_bytes > SPRITE_SAVE_BYTES) {
+    return -1;
+  }
+  int id = sprite_count++;
+  Sprite *s = &sprites[id];
+  memset(s, 0, sizeof(*s));
+  s->image = image;
+  s->z = z;
+  s->save = &save_pool[save_used];
+  save_used += save_bytes;
+
+  // Insertion into the z order, after sprites of equal z
+  int i = id;
+  while (i > 0 && sprites[order[i - 1]].z > z) {
+    order[i] = order[i - 1];
+    i--;
+  }
+  order[i] = id;
+  return id;
+}
+
+void sprite_move(int id, short x, short y) {
+  sprites[id].x = x;
+  sprites[id].y = y;
+}
+
+void sprite_set_visible(int id, bool visible) { sprites[id].visible = visible; }
+
+// Grow the line band [*y0, *y1) over a sprite at y
+static void band_add(const Sprite *s, short y, short *y0, short *y1) {
+  if (y < *y0) {
+    *y0 = y;
+  }
+  if (y + s->image->h > *y1) {
+    *y1 = y + s->image->h;
+  }
+}
+
+static void hide_sprites(void *arg, int data) {
+  (void)arg;
+  (void)data;
+  for (int i = sprite_count - 1; i >= 0; i--) {
+    Sprite *s = &sprites[order[i]];
+    Clip c;
+    if (s->drawn && clip_sprite(s, s->drawn_x, s->drawn_y, &c)) {
+      restore_under(s, &c);
+    }
+    s->drawn = false;
+  }
+}
+
+static void show_sprites(void *arg, int data) {
+  (void)arg;
+  (void)data;
+  for (int i = 0; i < sprite_count; i++) {
+    Sprite *s = &sprites[order[i]];
+    Clip c;
+    if (s->drawn || !s->show_visible ||
+        !clip_sprite(s, s->show_x, s->show_y, &c)) {
+      continue;
+    }
+    save_under(s, &c);
+    draw_sprite(s, s->show_x, s->show_y, &c);
+    s->drawn = true;
+    s->drawn_x = s->show_x;
+    s->drawn_y = s->show_y;
+  }
+}
+
+void sprite_layer_hide(void) {
+  if (scanout) {
+    return;
+  }
+  // Cover every queued show as well as what is drawn now, so this waits
+  // behind any show still queued
+  short y0 = VGA_HEIGHT, y1 = 0;
+  for (int i = 0; i < sprite_count; i++) {
+    Sprite *s = &sprites[i];
+    if (s->drawn) {
+      band_add(s, s->drawn_y, &y0, &y1);
+    }
+    if (s->show_visible) {
+      band_add(s, s->show_y, &y0, &y1);
+    }
+  }
+  if (y0 < y1) {
+    vga_draw_defer_ordered(y0, y1 - y0, hide_sprites, NULL, 0);
+  }
+}
+
+// Scanout mode's show: publish the visible sprites to the compositor
+static void publish_sprites(void) {
+  // Withdraw any unused copy first, so the compositor cannot switch to it
+  // while it is being written
+  scan_pending = -1;
+  int next = scan_live ^ 1;
+  ScanFrame *frame = &scan_frames[next];
+  frame->count = 0;
+  for (int i = 0; i < sprite_count; i++) {
+    Sprite *s = &sprites[order[i]];
+    if (!s->visible) {
+      continue;
+    }
+    ScanSprite add = {s->image, s->x, s->y, i};
+    int j = frame->count++;
+    while (j > 0 && frame->sprites[j - 1].y > add.y) {
+      frame->sprites[j] = frame->sprites[j - 1];
+      j--;
+    }
+    frame->sprites[j] = add;
+  }
+  scan_pending = next;
+}
+
+void sprite_layer_show(void) {
+  if (scanout) {
+    publish_sprites();
+    return;
+  }
+  short y0 = VGA_HEIGHT, y1 = 0;
+  for (int i = 0; i < sprite_count; i++) {
+    Sprite *s = &sprites[i];
+    s->show_visible = s->visible;
+    s->show_x = s->x;
+    s->show_y = s->y;
+    if (s->visible) {
+      band_add(s, s->y, &y0, &y1);
+    }
+  }
+  if (y0 < y1) {
+    vga_draw_defer_ordered(y0, y1 - y0, show_sprites, NULL, 0);
+  }
+}
+
+void sprite_layer_invalidate(void) {
+  for (int i = 0; i < sprite_count; i++) {
+    sprites[i].drawn = false;
+    sprites[i].show_visible = false;
+  }
+}
+
+void sprite_layer_set_scanout(bool on) { scanout = on; }
+
+int __not_in_flash_func(sprite_compose_line)(unsigned char *line, int y) {
+  if (y == 0 && scan_pending >= 0) {
+    scan_live = scan_pending;
+    scan_pending = -1;
+  }
+  const ScanFrame *frame = &scan_frames[scan_live];
+
+  // Sprites on this line, up to the limit, in z order
+  const ScanSprite *hits[SPRITE_LINE_LIMIT];
+  int count = 0;
+  for (int i = 0; i < frame->count && frame->sprites[i].y <= y; i++) {
+    const ScanSprite *s = &frame->sprites[i];
+    if (y >= s->y + s->image->h) {
+      continue;
+    }
+    if (count == SPRITE_LINE_LIMIT) {
+      line_overflow++;
+      continue;
+    }
+    int j = count++;
+    while (j > 0 && hits[j - 1]->rank > s->rank) {
+      hits[j] = hits[j - 1];
+      j--;
+    }
+    hits[j] = s;
+  }
+
+  for (int i = 0; i < count; i++) {
+    const ScanSprite *s = hits[i];
+    short x0 = s->x < 0 ? 0 : s->x;
+    short x1 = s->x + s->image->w > VGA_WIDTH ? VGA_WIDTH : s->x + s->image->w;
+    if (x0 < x1) {
+      draw_sprite_row(line, s->image, y - s->y, s->x, x0, x1);
+    }
+  }
+  return count;
+}
+
+uint32_t sprite_line_overflow(void) { return line_overflow; }
+
+void sprite_layer_reset(void) {
+  sprite_count = 0;
+  save_used = 0;
+}
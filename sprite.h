@@ -0,0 +1,63 @@
+#include "pico/stdlib.h"
+
+#ifndef SPRITE_H
+#define SPRITE_H
+
+// Sprites over the framebuffer with save-under. Before a sprite is drawn
+// the pixels under it are saved, and they are put back before it moves, so
+// a frame only touches sprite-sized areas and the background survives.
+//
+// A frame's update is bracketed by sprite_layer_hide() and
+// sprite_layer_show(). Both go on the VGA draw queue as ordered draws (see
+// vga_draw_defer_ordered), covering the lines of every sprite involved, so
+// background draws queued between them land while the sprites are off the
+// screen, and neither runs ahead of anything queued before it.
+
+#ifndef SPRITE_MAX
+#define SPRITE_MAX 32 // sprites
+#endif
+#ifndef SPRITE_SAVE_BYTES
+#define SPRITE_SAVE_BYTES 4096 // save-under pool shared by all sprites
+#endif
+
+// 4bpp bitmap, packed like the framebuffer: (w + 1) / 2 bytes per row, the
+// even column in the low nibble. Pixels of color key are transparent.
+typedef struct {
+  short w;
+  short h;
+  uint8_t key;
+  const uint8_t *pixels;
+} SpriteImage;
+
+// Add a sprite, hidden; higher z draws on top. Returns the sprite's id, or
+// -1 if there is no room for it or its save-under buffer.
+int sprite_add(const SpriteImage *image, int z);
+// Where the sprite goes (top-left corner) on the next sprite_layer_show()
+void sprite_move(int id, short x, short y);
+void sprite_set_visible(int id, bool visible);
+
+// Queue taking every drawn sprite off the screen, restoring what was under
+// it, topmost first
+void sprite_layer_hide(void);
+// Queue drawing the visible sprites at their current positions
+void sprite_layer_show(void);
+// The screen has been cleared: forget what the sprites were covering
+void sprite_layer_invalidate(void);
+// Remove all sprites. Only call with nothing queued or on screen.
+void sprite_layer_reset(void);
+
+// Scanout mode, for VGA_LINE_COMPOSE builds: the framebuffer is left alone
+// and sprite_layer_show() hands the visible sprites to
+// sprite_compose_line(), the VGA line hook, which draws them into each
+// line as it goes out. Up to SPRITE_LINE_LIMIT sprites are drawn on a
+// line; the rest are skipped and counted. Sprite updates must come from
+// the core taking the VGA interrupts. Choose the mode before adding
+// sprites.
+#ifndef SPRITE_LINE_LIMIT
+#define SPRITE_LINE_LIMIT 8
+#endif
+void sprite_layer_set_scanout(bool on);
+int sprite_compose_line(unsigned char *line, int y);
+uint32_t sprite_line_overflow(void); // sprites skipped on full lines
+
+#endif // SPRITE_H
@@ -0,0 +1,34 @@
+#include "static_layer.h"
+#include "vga16_graphics.h"
+
+void static_layer_init(StaticLayer *layer, unsigned char *pixels, short x,
+                       short y, short w, short h, LayerRenderFn render,
+                       void *arg) {
+  surface_init(&layer->surface, w, h, pixels);
+  layer->x = x;
+  layer->y = y;
+  layer->render = render;
+  layer->arg = arg;
+  layer->rendered = false;
+}
+
+void static_layer_restore(StaticLayer *layer) {
+  Surface *s = &layer->surface;
+  if (!layer->rendered) {
+    surface_fill(s, BLACK);
+    vga_set_target(s->pixels, s->w, s->h, layer->x, layer->y);
+    layer->render(layer->arg);
+    vga_set_target(NULL, 0, 0, 0, 0);
+    layer->rendered = true;
+  }
+  surface_blit_to_screen(s, layer->x, layer->y, NULL);
+}
+
+void static_layer_capture(StaticLayer *layer) {
+  Surface *s = &layer->surface;
+  surface_blit(s, 0, 0, surface_screen(), layer->x, layer->y, s->w, s->h,
+               NULL);
+  layer->rendered = true;
+}
+
+void static_layer_invalidate(StaticLayer *layer) { layer->rendered = false; }
@@ -0,0 +1,34 @@
+#include "surface.h"
+
+#ifndef STATIC_LAYER_H
+#define STATIC_LAYER_H
+
+// Screen furniture that rarely changes (frames, labels, logos), rendered
+// once with the drawing primitives into an off-screen surface and put back
+// on screen with a block copy whenever something drawn over it has to go.
+// The render function draws in screen coordinates, exactly as it would
+// onto the screen; whatever falls outside the layer is clipped.
+
+typedef void (*LayerRenderFn)(void *arg);
+
+typedef struct {
+  Surface surface;
+  short x, y; // screen position
+  LayerRenderFn render;
+  void *arg;
+  bool rendered; // surface holds an up to date render
+} StaticLayer;
+
+// pixels holds w / 2 * h bytes; w must be even
+void static_layer_init(StaticLayer *layer, unsigned char *pixels, short x,
+                       short y, short w, short h, LayerRenderFn render,
+                       void *arg);
+// Copy the layer to the screen, rendering it first if it is stale
+void static_layer_restore(StaticLayer *layer);
+// Fill the layer from what the screen shows at its position, for when the
+// screen was drawn some other way (e.g. decoded from an image)
+void static_layer_capture(StaticLayer *layer);
+// The layer's content changed: render it again on the next restore
+void static_layer_invalidate(StaticLayer *layer);
+
+#endif // STATIC_LAYER_H
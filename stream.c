@@ -0,0 +1,181 @@
+#include "stream.h"
+#include "rle.h"
+#include "vga16_graphics.h"
+#include <string.h>
+
+#define TILE_BYTES (STREAM_TILE_W / 2) // per row
+
+// Hash of each tile as last sent; known is false when the viewer may not
+// have it
+static uint32_t sent_hash[STREAM_BANDS][STREAM_TILES];
+static bool known[STREAM_BANDS][STREAM_TILES];
+
+static uint8_t ring[STREAM_RING_BYTES];
+static volatile uint32_t ring_head, ring_tail; // bytes in and out, ever
+
+// The packet being built, and the band being looked at, copied out of the
+// framebuffer so what is hashed is what is sent
+static uint8_t packet[STREAM_PACKET_MAX];
+static int packet_len, packet_regions;
+static uint8_t band_pixels[STREAM_TILE_H * VGA_STRIDE] __attribute__((aligned(4)));
+
+static int start_band;    // first band of the next frame
+static int bands_done;    // of this frame
+static bool packet_full;
+static int refresh_band;  // next band sent unconditionally
+static uint32_t captured; // frames begun
+static StreamStats stats;
+
+static void put16(uint8_t *p, uint32_t v) {
+  p[0] = v & 0xff;
+  p[1] = (v >> 8) & 0xff;
+}
+
+void stream_reset(void) { memset(known, 0, sizeof(known)); }
+
+int stream_queued(void) { return ring_head - ring_tail; }
+
+int stream_read(uint8_t *dst, int max) {
+  int n = stream_queued();
+  if (n > max) {
+    n = max;
+  }
+  for (int i = 0; i < n; i++) {
+    dst[i] = ring[(ring_tail + i) % STREAM_RING_BYTES];
+  }
+  ring_tail += n;
+  return n;
+}
+
+bool stream_frame_begin(uint32_t frame) {
+  if (STREAM_RING_BYTES - stream_queued() < STREAM_PACKET_MAX) {
+    stats.frames_dropped++;
+    return false;
+  }
+  if (captured++ % STREAM_REFRESH_FRAMES == 0) {
+    memset(known[refresh_band], 0, sizeof(known[refresh_band]));
+    refresh_band = (refresh_band + 1) % STREAM_BANDS;
+  }
+  memcpy(packet, "VGAF", 4);
+  put16(&packet[4], frame);
+  put16(&packet[6], frame >> 16);
+  packet_len = STREAM_HEADER_BYTES;
+  packet_regions = 0;
+  bands_done = 0;
+  packet_full = false;
+  return true;
+}
+
+static uint32_t tile_hash(const uint8_t *p) {
+  uint32_t h = 2166136261u;
+  for (int y = 0; y < STREAM_TILE_H; y++) {
+    const uint32_t *row = (const uint32_t *)&p[y * VGA_STRIDE];
+    for (int i = 0; i < TILE_BYTES / 4; i++) {
+      h = (h ^ row[i]) * 16777619u;
+    }
+  }
+  return h;
+}
+
+// Append tiles [t0, t1) of the band at y as one region; false if they do
+// not fit, leaving the packet as it was
+static bool put_region(int t0, int t1, int y) {
+  int x = t0 * STREAM_TILE_W, w = (t1 - t0) * STREAM_TILE_W;
+  int cap = STREAM_PACKET_MAX - 2; // the checksum
+  int len = packet_len + STREAM_REGION_BYTES;
+  if (len > cap) {
+    return false;
+  }
+  RleEncoder e;
+  rle_encoder_init(&e);
+  for (int row = 0; row < STREAM_TILE_H; row++) {
+    int n = rle_encoder_write(&e, &band_pixels[row * VGA_STRIDE + x / 2],
+                              NULL, w / 2, &packet[len], cap - len);
+    if (n < 0) {
+      return false;
+    }
+    len += n;
+  }
+  int n = rle_encoder_finish(&e, &packet[len], cap - len);
+  if (n < 0) {
+    return false;
+  }
+  len += n;
+
+  uint8_t *region = &packet[packet_len];
+  put16(&region[0], x);
+  put16(&region[2], y);
+  put16(&region[4], w);
+  put16(&region[6], STREAM_TILE_H);
+  put16(&region[8], len - packet_len - STREAM_REGION_BYTES);
+  packet_len = len;
+  packet_regions++;
+  return true;
+}
+
+bool stream_frame_step(void) {
+  if (packet_full || bands_done == STREAM_BANDS) {
+    return false;
+  }
+  int band = (start_band + bands_done) % STREAM_BANDS;
+  int y = band * STREAM_TILE_H;
+  memcpy(band_pixels, &vga_data_array[y * VGA_STRIDE], sizeof(band_pixels));
+
+  uint32_t hash[STREAM_TILES];
+  bool changed[STREAM_TILES];
+  for (int t = 0; t < STREAM_TILES; t++) {
+    hash[t] = tile_hash(&band_pixels[t * TILE_BYTES]);
+    changed[t] = !known[band][t] || hash[t] != sent_hash[band][t];
+  }
+
+  // Runs of changed tiles, each marked sent once it is in the packet. A
+  // run that does not fit is cut down, so even a busy band goes out a
+  // piece at a time; what is left waits for the next frame, which starts
+  // at this band.
+  for (int t = 0; t < STREAM_TILES;) {
+    if (!changed[t]) {
+      t++;
+      continue;
+    }
+    int end = t + 1;
+    while (end < STREAM_TILES && changed[end]) {
+      end++;
+    }
+    while (!put_region(t, end, y)) {
+      if (end == t + 1) {
+        packet_full = true;
+        return false;
+      }
+      end = t + (end - t) / 2;
+    }
+    for (; t < end; t++) {
+      sent_hash[band][t] = hash[t];
+      known[band][t] = true;
+    }
+  }
+  bands_done++;
+  return true;
+}
+
+void stream_frame_end(void) {
+  start_band = (start_band + bands_done) % STREAM_BANDS;
+  if (packet_full) {
+    stats.frames_cut++;
+  }
+  if (packet_regions == 0) {
+    return; // nothing changed
+  }
+  put16(&packet[8], packet_regions);
+  put16(&packet[10], packet_len - STREAM_HEADER_BYTES);
+  put16(&packet[packet_len], stream_checksum(packet, packet_len));
+  packet_len += 2;
+
+  for (int i = 0; i < packet_len; i++) {
+    ring[(ring_head + i) % STREAM_RING_BYTES] = packet[i];
+  }
+  ring_head += packet_len;
+  stats.frames_sent++;
+  stats.bytes_sent += packet_len;
+}
+
+void stream_get_stats(StreamStats *s) { *s = stats; }
@@ -0,0 +1,88 @@
+#include "pico/stdlib.h"
+
+#ifndef STREAM_H
+#define STREAM_H
+
+// Remote viewing: the parts of the screen that changed since they were
+// last sent, run-length coded (rle.h) into packets for the serial link.
+//
+// The screen is cut into tiles; a tile is sent again when its hash
+// differs from the one it had when last sent. Each frame's changed tiles
+// are merged into runs along a band of tiles and packed into one packet,
+// which goes into a bounded ring for a low-priority sender to drain. When
+// the ring has no room for a packet the frame is dropped, and when a
+// packet fills up the frame is cut short; either way the tiles not sent
+// stay changed and go out with a later frame, so a slow link lowers the
+// frame rate instead of holding up drawing. One band a while is sent
+// again whether changed or not, so a viewer that joins late or loses a
+// packet catches up.
+//
+// Only the framebuffer is seen: sprites composited at scanout
+// (VGA_LINE_COMPOSE) are not.
+//
+// Packet, little-endian:
+//   "VGAF"  u32 frame  u16 regions  u16 payload bytes
+//   payload: per region u16 x, y, w, h (pixels), u16 bytes, then that many
+//            bytes of rle stream, w / 2 bytes per row
+//   u16 Fletcher-16 of everything before it
+// Bytes between packets (console output) are not part of the stream.
+
+#define STREAM_TILE_W 64 // pixels
+#define STREAM_TILE_H 16
+#define STREAM_TILES (VGA_WIDTH / STREAM_TILE_W) // per band
+#define STREAM_BANDS (VGA_HEIGHT / STREAM_TILE_H)
+
+#ifndef STREAM_RING_BYTES
+#define STREAM_RING_BYTES 8192 // must be a power of two
+#endif
+// The ring's byte counters wrap, so its size must divide 2^32
+_Static_assert((STREAM_RING_BYTES & (STREAM_RING_BYTES - 1)) == 0,
+               "STREAM_RING_BYTES must be a power of two");
+#ifndef STREAM_PACKET_MAX
+#define STREAM_PACKET_MAX 2048 // bytes, header and checksum included
+#endif
+#ifndef STREAM_REFRESH_FRAMES
+#define STREAM_REFRESH_FRAMES 8 // frames per band sent unconditionally
+#endif
+
+#define STREAM_HEADER_BYTES 12
+#define STREAM_REGION_BYTES 10
+
+typedef struct {
+  uint32_t frames_sent;
+  uint32_t frames_dropped; // no room in the ring
+  uint32_t frames_cut;     // packet full before every band was looked at
+  uint32_t bytes_sent;     // queued into the ring
+} StreamStats;
+
+// The viewer knows nothing: every tile is sent again
+void stream_reset(void);
+
+// Capture a frame, a band of tiles at a time so the caller can yield in
+// between:
+//   if (stream_frame_begin(frame)) {
+//     while (stream_frame_step()) { ... }
+//     stream_frame_end();
+//   }
+// begin returns false, dropping the frame, if the ring is too full. step
+// returns false once the frame is done.
+bool stream_frame_begin(uint32_t frame);
+bool stream_frame_step(void);
+void stream_frame_end(void);
+
+// Bytes in the ring; stream_read() takes up to max of them
+int stream_queued(void);
+int stream_read(uint8_t *dst, int max);
+
+void stream_get_stats(StreamStats *stats);
+
+static inline uint16_t stream_checksum(const uint8_t *data, int len) {
+  uint32_t a = 0, b = 0;
+  for (int i = 0; i < len; i++) {
+    a = (a + data[i]) % 255;
+    b = (b + a) % 255;
+  }
+  return b << 8 | a;
+}
+
+#endif // STREAM_H
@@ -0,0 +1,145 @@
+/**
+ * Remote viewer for the frame stream (host build only)
+ *
+ * Reads what the device sent over the serial link while streaming (the
+ * "stream" console command, see stream.h), rebuilds the screen from the
+ * packets and writes each frame out as a PPM image. Console text and
+ * damaged packets in the capture are skipped. Until every part of the
+ * screen has been sent, the parts not seen yet are black.
+ *
+ * Build with the SDK host platform:
+ *   cmake -S . -B build-host -DPICO_PLATFORM=host && cmake --build build-host
+ *
+ * Usage: stream_view <capture> [prefix]
+ *   Writes <prefix>NNNNN.ppm (default prefix "frame_") for each packet;
+ *   "-" reads the capture from stdin, e.g. straight off the serial port.
+ */
+#include "rle.h"
+#include "stream.h"
+#include "vga16_graphics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PAYLOAD_MAX (STREAM_PACKET_MAX - STREAM_HEADER_BYTES - 2)
+
+static uint8_t packet[STREAM_PACKET_MAX];
+
+// The 4-bit color is red, blue and two bits of green, as on the DAC pins
+static void color_rgb(int c, uint8_t rgb[3]) {
+  rgb[0] = c & 8 ? 255 : 0;
+  rgb[1] = (c & 3) * 85;
+  rgb[2] = c & 4 ? 255 : 0;
+}
+
+static uint16_t get16(const uint8_t *p) { return p[0] | p[1] << 8; }
+
+static bool write_ppm(const char *path) {
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  fprintf(f, "P6\n%d %d\n255\n", VGA_WIDTH, VGA_HEIGHT);
+  for (int y = 0; y < VGA_HEIGHT; y++) {
+    for (int x = 0; x < VGA_WIDTH; x++) {
+      uint8_t byte = vga_data_array[y * VGA_STRIDE + x / 2];
+      uint8_t rgb[3];
+      color_rgb(x & 1 ? byte >> 4 : byte & 0x0f, rgb);
+      fwrite(rgb, 1, 3, f);
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+// Apply the regions of a packet that passed its checksum. They were
+// checked as a whole before anything is drawn.
+static bool apply_packet(int regions, int payload) {
+  const uint8_t *p = &packet[STREAM_HEADER_BYTES];
+  const uint8_t *end = p + payload;
+  for (int pass = 0; pass < 2; pass++) {
+    p = &packet[STREAM_HEADER_BYTES];
+    for (int i = 0; i < regions; i++) {
+      if (end - p < STREAM_REGION_BYTES) {
+        return false;
+      }
+      int x = get16(p), y = get16(p + 2), w = get16(p + 4), h = get16(p + 6);
+      int len = get16(p + 8);
+      p += STREAM_REGION_BYTES;
+      if ((x | w) & 1 || x + w > VGA_WIDTH || y + h > VGA_HEIGHT ||
+          end - p < len) {
+        return false;
+      }
+      if (pass == 1) {
+        RleDecoder d;
+        rle_decoder_init(&d, &vga_data_array[y * VGA_STRIDE + x / 2], w / 2,
+                         VGA_STRIDE, h, false);
+        if (rle_decoder_write(&d, p, len) < 0 || !rle_decoder_done(&d)) {
+          return false;
+        }
+      }
+      p += len;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <capture> [prefix]\n", argv[0]);
+    return 1;
+  }
+  const char *prefix = argc > 2 ? argv[2] : "frame_";
+  FILE *in = strcmp(argv[1], "-") == 0 ? stdin : fopen(argv[1], "rb");
+  if (!in) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  memset(vga_data_array, 0, VGA_STRIDE * VGA_HEIGHT);
+  int frames = 0, damaged = 0;
+  int matched = 0; // bytes of "VGAF" seen so far
+  int c;
+  while ((c = fgetc(in)) != EOF) {
+    // Look for the start of a packet
+    if (c != "VGAF"[matched]) {
+      matched = c == 'V';
+      continue;
+    }
+    if (++matched < 4) {
+      continue;
+    }
+    matched = 0;
+
+    memcpy(packet, "VGAF", 4);
+    if (fread(&packet[4], 1, STREAM_HEADER_BYTES - 4, in) !=
+        STREAM_HEADER_BYTES - 4) {
+      break;
+    }
+    int regions = get16(&packet[8]), payload = get16(&packet[10]);
+    if (payload > PAYLOAD_MAX) {
+      damaged++;
+      continue;
+    }
+    int rest = payload + 2;
+    if (fread(&packet[STREAM_HEADER_BYTES], 1, rest, in) != rest) {
+      break;
+    }
+    int len = STREAM_HEADER_BYTES + payload;
+    if (get16(&packet[len]) != stream_checksum(packet, len) ||
+        !apply_packet(regions, payload)) {
+      damaged++;
+      continue;
+    }
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s%05d.ppm", prefix, frames);
+    if (!write_ppm(path)) {
+      return 1;
+    }
+    frames++;
+  }
+  fprintf(stderr, "%d frames, %d damaged packets skipped\n", frames, damaged);
+  return 0;
+}
@@ -0,0 +1,126 @@
+#include "surface.h"
+#include "vga16_graphics.h"
+#include <string.h>
+
+static Surface screen = {VGA_WIDTH, VGA_HEIGHT, VGA_STRIDE, vga_data_array};
+
+void surface_init(Surface *s, short w, short h, unsigned char *pixels) {
+  s->w = w;
+  s->h = h;
+  s->stride = (w + 1) / 2;
+  s->pixels = pixels;
+}
+
+Surface *surface_screen(void) { return &screen; }
+
+void surface_fill(Surface *s, char color) {
+  uint8_t pair = (color & 0x0f) * 0x11;
+  for (int y = 0; y < s->h; y++) {
+    memset(&s->pixels[y * s->stride], pair, (s->w + 1) / 2);
+  }
+}
+
+static inline uint8_t get_pixel(const unsigned char *row, int x) {
+  return (row[x >> 1] >> ((x & 1) * 4)) & 0x0f;
+}
+
+static inline void put_pixel(unsigned char *row, int x, uint8_t color) {
+  unsigned char *byte = &row[x >> 1];
+  *byte = x & 1 ? (*byte & 0x0f) | (color << 4) : (*byte & 0xf0) | color;
+}
+
+// One row of a plain copy. Whole byte pairs are copied between the edge
+// nibbles; when source and destination differ in nibble alignment each
+// destination byte joins the high nibble of one source byte with the low
+// nibble of the next.
+static void copy_row(unsigned char *d, int dx, const unsigned char *s, int sx,
+                     int w) {
+  if (dx & 1) {
+    put_pixel(d, dx++, get_pixel(s, sx++));
+    w--;
+  }
+  int pairs = w >> 1;
+  unsigned char *dp = &d[dx >> 1];
+  const unsigned char *sp = &s[sx >> 1];
+  if (!(sx & 1)) {
+    memmove(dp, sp, pairs);
+  } else {
+    for (int i = 0; i < pairs; i++) {
+      dp[i] = (sp[i] >> 4) | (sp[i + 1] << 4);
+    }
+  }
+  if (w & 1) {
+    put_pixel(d, dx + w - 1, get_pixel(s, sx + w - 1));
+  }
+}
+
+// One row with a color key and/or palette remap, pixel by pixel. The key
+// is compared with the source color, before any remap.
+static void map_row(unsigned char *d, int dx, const unsigned char *s, int sx,
+                    int w, int key, const uint8_t *remap) {
+  for (int i = 0; i < w; i++) {
+    uint8_t color = get_pixel(s, sx + i);
+    if (color == key) {
+      continue;
+    }
+    put_pixel(d, dx + i, remap ? remap[color] : color);
+  }
+}
+
+void surface_blit(Surface *dst, short dx, short dy, const Surface *src,
+                  short sx, short sy, short w, short h,
+                  const BlitOptions *opt) {
+  // Clip against the source, then the destination
+  if (sx < 0) {
+    dx -= sx;
+    w += sx;
+    sx = 0;
+  }
+  if (sy < 0) {
+    dy -= sy;
+    h += sy;
+    sy = 0;
+  }
+  if (dx < 0) {
+    sx -= dx;
+    w += dx;
+    dx = 0;
+  }
+  if (dy < 0) {
+    sy -= dy;
+    h += dy;
+    dy = 0;
+  }
+  if (sx + w > src->w) {
+    w = src->w - sx;
+  }
+  if (sy + h > src->h) {
+    h = src->h - sy;
+  }
+  if (dx + w > dst->w) {
+    w = dst->w - dx;
+  }
+  if (dy + h > dst->h) {
+    h = dst->h - dy;
+  }
+  if (w <= 0 || h <= 0) {
+    return;
+  }
+
+  int key = opt ? opt->key : -1;
+  const uint8_t *remap = opt ? opt->remap : NULL;
+  for (int y = 0; y < h; y++) {
+    unsigned char *d = &dst->pixels[(dy + y) * dst->stride];
+    const unsigned char *s = &src->pixels[(sy + y) * src->stride];
+    if (key < 0 && !remap) {
+      copy_row(d, dx, s, sx, w);
+    } else {
+      map_row(d, dx, s, sx, w, key, remap);
+    }
+  }
+}
+
+void surface_blit_to_screen(const Surface *src, short x, short y,
+                            const BlitOptions *opt) {
+  surface_blit(&screen, x, y, src, 0, 0, src->w, src->h, opt);
+}
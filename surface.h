@@ -0,0 +1,42 @@
+#include "pico/stdlib.h"
+
+#ifndef SURFACE_H
+#define SURFACE_H
+
+// Off-screen 4bpp images, packed like the framebuffer: two pixels per
+// byte, the even column in the low nibble. The screen is a surface too, so
+// the same blit copies screen to surface, surface to screen or between
+// surfaces.
+
+typedef struct {
+  short w;
+  short h;
+  short stride;          // bytes per row
+  unsigned char *pixels; // h rows of stride bytes
+} Surface;
+
+// How a blit treats the source pixels
+typedef struct {
+  int key;              // color left transparent, or -1 to copy every pixel
+  const uint8_t *remap; // 16 entries: drawn color for each source color
+} BlitOptions;
+
+// A surface over caller-provided pixels, (w + 1) / 2 bytes per row
+void surface_init(Surface *s, short w, short h, unsigned char *pixels);
+// vga_data_array as a surface
+Surface *surface_screen(void);
+
+void surface_fill(Surface *s, char color);
+
+// Copy the w x h block at (sx, sy) in src to (dx, dy) in dst, clipped to
+// both surfaces. opt may be NULL for a plain copy. src and dst must not
+// overlap unless they are the same block.
+void surface_blit(Surface *dst, short dx, short dy, const Surface *src,
+                  short sx, short sy, short w, short h,
+                  const BlitOptions *opt);
+
+// A whole surface onto the screen with its top-left corner at (x, y)
+void surface_blit_to_screen(const Surface *src, short x, short y,
+                            const BlitOptions *opt);
+
+#endif // SURFACE_H
@@ -0,0 +1,188 @@
+#include "task_pool.h"
+
+#if PICO_ON_DEVICE
+#include "hardware/sync.h"
+
+typedef spin_lock_t *PoolLock;
+
+static inline int this_core(void) { return get_core_num(); }
+static inline uint32_t pool_lock(PoolLock lock) {
+  return spin_lock_blocking(lock);
+}
+static inline void pool_unlock(PoolLock lock, uint32_t irq_state) {
+  spin_unlock(lock, irq_state);
+}
+// Wake the other core if it is waiting in __wfe()
+static inline void pool_wake(void) { __sev(); }
+#else
+#include <pthread.h>
+#include <sched.h>
+
+typedef pthread_mutex_t *PoolLock;
+
+static pthread_mutex_t host_locks[2] = {PTHREAD_MUTEX_INITIALIZER,
+                                        PTHREAD_MUTEX_INITIALIZER};
+static __thread int host_core; // 0 for the main thread, 1 for the worker
+
+static inline int this_core(void) { return host_core; }
+static inline uint32_t pool_lock(PoolLock lock) {
+  pthread_mutex_lock(lock);
+  return 0;
+}
+static inline void pool_unlock(PoolLock lock, uint32_t irq_state) {
+  (void)irq_state;
+  pthread_mutex_unlock(lock);
+}
+static inline void pool_wake(void) {}
+#endif
+
+typedef struct {
+  TaskFn fn;
+  void *arg;
+  int begin, end;
+  volatile int *pending; // tasks of the job still to finish
+  int home;              // deque the job was submitted to
+} Task;
+
+// Ring of tasks: the owner pushes and pops at the bottom, the other core
+// steals from the top. bottom - top is the number of tasks held.
+typedef struct {
+  Task tasks[TASK_POOL_CAPACITY];
+  volatile int top, bottom;
+  PoolLock lock;
+} Deque;
+
+static Deque deques[2];
+static TaskPoolStats pool_stats;
+
+void task_pool_init(void) {
+  for (int i = 0; i < 2; i++) {
+    deques[i].top = deques[i].bottom = 0;
+#if PICO_ON_DEVICE
+    deques[i].lock = spin_lock_instance(spin_lock_claim_unused(true));
+#else
+    deques[i].lock = &host_locks[i];
+#endif
+  }
+}
+
+// Run a task and count it off its job; the job's counter is guarded by the
+// lock of the deque the job was submitted to
+static void run_task(const Task *task, int core) {
+  task->fn(task->arg, task->begin, task->end);
+  Deque *home = &deques[task->home];
+  uint32_t irq_state = pool_lock(home->lock);
+  (*task->pending)--;
+  pool_unlock(home->lock, irq_state);
+  pool_stats.tasks_run[core]++;
+}
+
+bool task_pool_work(void) {
+  int core = this_core();
+  Deque *own = &deques[core];
+  Deque *other = &deques[core ^ 1];
+  Task task;
+  uint32_t irq_state;
+
+  // Newest own task first: its data is most likely still in use here
+  irq_state = pool_lock(own->lock);
+  if (own->bottom != own->top) {
+    own->bottom--;
+    task = own->tasks[own->bottom % TASK_POOL_CAPACITY];
+    pool_unlock(own->lock, irq_state);
+    run_task(&task, core);
+    return true;
+  }
+  pool_unlock(own->lock, irq_state);
+
+  // Steal the oldest task of the other core
+  irq_state = pool_lock(other->lock);
+  if (other->bottom != other->top) {
+    task = other->tasks[other->top % TASK_POOL_CAPACITY];
+    other->top++;
+    pool_unlock(other->lock, irq_state);
+    pool_stats.steals[core]++;
+    run_task(&task, core);
+    return true;
+  }
+  pool_unlock(other->lock, irq_state);
+  return false;
+}
+
+bool task_pool_pending(void) {
+  return deques[0].bottom != deques[0].top ||
+         deques[1].bottom != deques[1].top;
+}
+
+void task_pool_run(TaskFn fn, void *arg, int count, int grain) {
+  int core = this_core();
+  Deque *own = &deques[core];
+  volatile int pending = 0;
+  uint32_t irq_state;
+
+  if (count <= 0) {
+    return;
+  }
+  // Coarsen the grain until the whole job fits in a deque
+  int min_grain = (count + TASK_POOL_CAPACITY - 1) / TASK_POOL_CAPACITY;
+  if (grain < min_grain) {
+    grain = min_grain;
+  }
+  if (grain < 1) {
+    grain = 1;
+  }
+
+  irq_state = pool_lock(own->lock);
+  for (int begin = 0; begin < count; begin += grain) {
+    int end = begin + grain < count ? begin + grain : count;
+    Task task = {fn, arg, begin, end, &pending, core};
+    if (own->bottom - own->top == TASK_POOL_CAPACITY) {
+      // Full with another job's tasks: do this one here
+      pending++;
+      pool_unlock(own->lock, irq_state);
+      run_task(&task, core);
+      irq_state = pool_lock(own->lock);
+      continue;
+    }
+    own->tasks[own->bottom % TASK_POOL_CAPACITY] = task;
+    own->bottom++;
+    pending++;
+  }
+  pool_unlock(own->lock, irq_state);
+  pool_wake();
+
+  // Help until every task of this job is done, wherever it ran
+  while (pending) {
+    if (!task_pool_work()) {
+      tight_loop_contents();
+    }
+  }
+}
+
+void task_pool_get_stats(TaskPoolStats *stats) { *stats = pool_stats; }
+
+#if !PICO_ON_DEVICE
+static pthread_t worker;
+static volatile bool worker_running;
+
+static void *worker_main(void *unused) {
+  (void)unused;
+  host_core = 1;
+  while (worker_running) {
+    if (!task_pool_work()) {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+void task_pool_start_worker(void) {
+  worker_running = true;
+  pthread_create(&worker, NULL, worker_main, NULL);
+}
+
+void task_pool_stop_worker(void) {
+  worker_running = false;
+  pthread_join(worker, NULL);
+}
+#endif
@@ -0,0 +1,48 @@
+#include "pico/stdlib.h"
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+// Small fork-join task pool shared by both cores. A job is split into
+// tasks over index ranges, which go into the submitting core's deque; the
+// submitter works through its own deque from the bottom while the other
+// core steals from the top. Each deque is guarded by an RP2040 hardware
+// spinlock (the M0+ has no atomic read-modify-write to build a lock-free
+// deque on). In the host build the "cores" are pthreads.
+//
+// Tasks must only write state that no other task of the same job touches.
+
+#ifndef TASK_POOL_CAPACITY
+#define TASK_POOL_CAPACITY 64 // tasks per deque
+#endif
+
+typedef void (*TaskFn)(void *arg, int begin, int end);
+
+void task_pool_init(void);
+
+// Run fn over [0, count) in tasks of at least grain indices and wait for
+// all of them. The caller runs tasks too, so this completes even if the
+// other core never helps.
+void task_pool_run(TaskFn fn, void *arg, int count, int grain);
+
+// Run one queued task, from this core's deque or stolen from the other.
+// Returns false if there was nothing to run.
+bool task_pool_work(void);
+
+// Whether any deque holds a task (a cheap unlocked check for idle loops)
+bool task_pool_pending(void);
+
+typedef struct {
+  uint32_t tasks_run[2]; // per core
+  uint32_t steals[2];    // tasks a core took from the other core's deque
+} TaskPoolStats;
+
+void task_pool_get_stats(TaskPoolStats *stats);
+
+#if !PICO_ON_DEVICE
+// Start a pthread that plays core 1, running tasks as they appear
+void task_pool_start_worker(void);
+void task_pool_stop_worker(void);
+#endif
+
+#endif // TASK_POOL_H
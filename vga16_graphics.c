@@ -1,27 +1,42 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "pico/stdlib.h"
+// The host build (PICO_PLATFORM=host) has no PIO, DMA or interpolator;
+// it draws into vga_data_array only
+#if PICO_ON_DEVICE
 #include "hardware/pio.h"
 #include "hardware/dma.h"
+#include "hardware/interp.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
 // Our assembled programs:
 // Each gets the name <pio_filename.pio.h>
 #include "hsync.pio.h"
 #include "vsync.pio.h"
+#if VGA_LOWRES
+#include "rgb_lowres.pio.h"
+#else
 #include "rgb.pio.h"
+#endif
+#endif
 // Header file
 #include "vga16_graphics.h"
 // Font file
 #include "glcdfont.c"
 #include "font_rom_brl4.h"
 
-// VGA timing constants
+// VGA timing constants. The signal is 640x480 in both modes; at 320x240
+// the rgb program shows each pixel twice and the DMA sends each line twice.
 #define H_ACTIVE   655    // (active + frontporch - 1) - one cycle delay for mov
 #define V_ACTIVE   479    // (active - 1)
-#define RGB_ACTIVE 319    // (horizontal active)/2 - 1
+#define V_LINES    480    // active lines sent
+#define RGB_ACTIVE (VGA_STRIDE - 1)    // bytes per framebuffer line - 1
 // #define RGB_ACTIVE 639 // change to this if 1 pixel/byte
 
 // Length of the pixel array, and number of DMA transfers
-#define TXCOUNT 153600 // Total pixels/2 (since we have 2 pixels per byte)
+#define TXCOUNT (VGA_STRIDE * VGA_HEIGHT) // Total pixels/2 (since we have 2 pixels per byte)
 
 // Pixel color array that is DMA's to the PIO machines and
 // a pointer to the ADDRESS of this color array.
@@ -29,6 +44,33 @@
 unsigned char vga_data_array[TXCOUNT];
 char * address_pointer = &vga_data_array[0] ;
 
+// Frame clock, advanced by the vsync program's IRQ 2
+volatile uint32_t vga_frame_count ;
+volatile uint32_t vga_vblank_us ;
+
+// DMA channel sending the pixels, read back for the beam position
+static int vga_pixel_chan ;
+
+#if VGA_LOWRES
+// Control blocks for the pixel channel: the start of each line sent, every
+// framebuffer line twice. The control channel writes one into the pixel
+// channel's read address trigger per line; the two spare entries repeat
+// the first two, so the table can be rewound a line or two late.
+static const unsigned char *line_table[V_LINES + 2] __attribute__((aligned(4))) ;
+static int vga_control_chan ;
+#endif
+
+// Draws waiting for the beam to clear their lines, oldest first
+typedef struct {
+    short y0, y1 ;
+    VgaDrawFn fn ;
+    void *arg ;
+    int data ;
+    bool ordered ;      // never runs ahead of an earlier draw
+} VgaDraw ;
+static VgaDraw draw_queue[VGA_DRAW_QUEUE] ;
+static int draw_count ;
+
 // Bit masks for drawPixel routine
 #define TOPMASK 0b00001111
 #define BOTTOMMASK 0b11110000
@@ -46,9 +88,206 @@ char * address_pointer = &vga_data_array[0] ;
 unsigned short cursor_y, cursor_x, textsize ;
 char textcolor, textbgcolor, wrap;
 
-// Screen width/height
-#define _width 640
-#define _height 480
+// Where this core's primitives draw: the screen, or an off-screen buffer
+// standing in for the screen rectangle at (x0, y0) -- see vga_set_target.
+// Per core, since both cores draw.
+typedef struct {
+    unsigned char *base ;
+    short w, h ;        // pixels; w is also the pixel pitch of a row
+    short x0, y0 ;      // screen position of the buffer's first pixel
+} DrawTarget ;
+
+static DrawTarget draw_targets[2] = {
+    {vga_data_array, VGA_WIDTH, VGA_HEIGHT, 0, 0},
+    {vga_data_array, VGA_WIDTH, VGA_HEIGHT, 0, 0},
+} ;
+
+static inline DrawTarget *draw_target(void) {
+    return &draw_targets[get_core_num()] ;
+}
+
+void vga_set_target(unsigned char *pixels, short w, short h, short x, short y) {
+    DrawTarget *t = draw_target() ;
+    if (pixels) {
+        *t = (DrawTarget){pixels, w, h, x, y} ;
+    } else {
+        *t = (DrawTarget){vga_data_array, VGA_WIDTH, VGA_HEIGHT, 0, 0} ;
+    }
+}
+
+// The primitives look the target up once and pass it down
+
+// Pixel index of screen point (x, y) in target t
+static inline int fb_index(const DrawTarget *t, int x, int y) {
+    return t->w * (y - t->y0) + (x - t->x0) ;
+}
+
+// True if the w x h box at (x, y) lies entirely on target t
+static inline bool on_screen(const DrawTarget *t, int x, int y, int w, int h) {
+    return x >= t->x0 && y >= t->y0 &&
+           x + w <= t->x0 + t->w && y + h <= t->y0 + t->h ;
+}
+
+// ==========================================
+// === framebuffer address generation
+// ==========================================
+// The span kernels walk the framebuffer with a fixed pixel stride (1 for a
+// horizontal run, 640 for a vertical one). On the RP2040 the per-core SIO
+// interpolator does the index arithmetic: lane 0 holds the pixel index and
+// adds the stride each time it is popped, lane 1 reads lane 0's accumulator
+// (cross input), shifts it right by one and adds the base of the target,
+// so it hands back the byte address directly. The host build walks the same
+// index in software and writes exactly the same pixels.
+// Callers must clip first -- spans never range check.
+#if PICO_ON_DEVICE
+static bool fb_interp_ready[2] ;
+static unsigned char *fb_interp_base[2] ;
+
+static inline void fb_span_begin(const DrawTarget *t, int pixel, int stride) {
+    uint core = t - draw_targets ;   // each core draws to its own target
+    unsigned char *base = t->base ;
+    if (!fb_interp_ready[core]) {
+        interp_config lane0 = interp_default_config() ;
+        interp_config_set_add_raw(&lane0, true) ;
+        interp_set_config(interp0, 0, &lane0) ;
+
+        interp_config lane1 = interp_default_config() ;
+        interp_config_set_cross_input(&lane1, true) ;
+        interp_config_set_shift(&lane1, 1) ;
+        interp_set_config(interp0, 1, &lane1) ;
+        fb_interp_ready[core] = true ;
+    }
+    if (fb_interp_base[core] != base) {
+        interp_set_base(interp0, 1, (uint32_t)base) ;
+        fb_interp_base[core] = base ;
+    }
+    interp_set_base(interp0, 0, (uint32_t)stride) ;
+    interp_set_accumulator(interp0, 0, (uint32_t)pixel) ;
+}
+
+// Write the current pixel and advance by the stride
+static inline void fb_span_put(char color) {
+    uint32_t pixel = interp_get_accumulator(interp0, 0) ;
+    unsigned char *byte = (unsigned char *)interp_peek_lane_result(interp0, 1) ;
+    (void)interp_pop_lane_result(interp0, 0) ;
+    if (pixel & 1) *byte = (*byte & TOPMASK) | (color << 4) ;
+    else           *byte = (*byte & BOTTOMMASK) | color ;
+}
+
+// Advance by the stride without writing
+static inline void fb_span_skip(void) {
+    (void)interp_pop_lane_result(interp0, 0) ;
+}
+
+// Move the current pixel by an extra offset (e.g. a line's minor-axis step)
+static inline void fb_span_shift(int delta) {
+    interp_add_accumulater(interp0, 0, (uint32_t)delta) ;
+}
+#else
+static int fb_span_pixel, fb_span_stride ;
+static unsigned char *fb_span_base ;
+
+static inline void fb_span_begin(const DrawTarget *t, int pixel, int stride) {
+    fb_span_base = t->base ;
+    fb_span_pixel = pixel ;
+    fb_span_stride = stride ;
+}
+
+static inline void fb_span_put(char color) {
+    unsigned char *byte = &fb_span_base[fb_span_pixel >> 1] ;
+    if (fb_span_pixel & 1) *byte = (*byte & TOPMASK) | (color << 4) ;
+    else                   *byte = (*byte & BOTTOMMASK) | color ;
+    fb_span_pixel += fb_span_stride ;
+}
+
+static inline void fb_span_skip(void) {
+    fb_span_pixel += fb_span_stride ;
+}
+
+static inline void fb_span_shift(int delta) {
+    fb_span_pixel += delta ;
+}
+#endif
+
+#if PICO_ON_DEVICE
+// PIO0_IRQ_0 handler: vsync has just started the last active line
+static void vga_vblank_irq(void) {
+#if VGA_LOWRES
+    // The last line is going out; rewind the control blocks to the top
+    const unsigned char **next = (const unsigned char **)dma_hw->ch[vga_control_chan].read_addr ;
+    if (next >= &line_table[V_LINES]) {
+        dma_hw->ch[vga_control_chan].read_addr = (uintptr_t)(next - V_LINES) ;
+    }
+#endif
+    vga_vblank_us = time_us_32() ;
+    vga_frame_count++ ;
+    // Only now, so that vga_get_scanline() sees either the flag or the new
+    // vga_vblank_us
+    pio_interrupt_clear(pio0, 2) ;
+    // Wake the other core as well, if it is waiting in __wfe()
+    __sev() ;
+}
+
+#if VGA_LINE_COMPOSE
+// Two line buffers, each sent by its own DMA channel; the channels chain to
+// each other. When one finishes, the other is already sending the next
+// line, which leaves one line period to refill the finished buffer with
+// the line after that.
+static unsigned char line_buffers[2][VGA_STRIDE] __attribute__((aligned(4))) ;
+static int line_chan[2] ;
+static int line_of[2] ;                 // line each buffer holds
+static volatile int vga_scan_line ;     // line being sent now
+static VgaLineHook line_hook ;
+static VgaLineStats line_stats ;
+
+void vga_set_line_hook(VgaLineHook hook) {
+    line_hook = hook ;
+}
+
+static void __not_in_flash_func(compose_line)(int b, int y) {
+    // SysTick counts CPU cycles down from 2^24
+    uint32_t start = systick_hw->cvr ;
+    memcpy(line_buffers[b], &vga_data_array[y * VGA_STRIDE], VGA_STRIDE) ;
+    int sprites = line_hook ? line_hook(line_buffers[b], y) : 0 ;
+    uint32_t cycles = (start - systick_hw->cvr) & 0x00ffffff ;
+
+    line_stats.lines++ ;
+    if (cycles > line_stats.max_cycles) line_stats.max_cycles = cycles ;
+    if (cycles > line_stats.budget) line_stats.late++ ;
+    if (sprites) {
+        line_stats.sprite_lines++ ;
+        line_stats.sprite_cycles += cycles ;
+        line_stats.sprites += sprites ;
+        if (sprites > line_stats.max_sprites) line_stats.max_sprites = sprites ;
+    } else {
+        line_stats.base_cycles += cycles ;
+    }
+}
+
+// DMA_IRQ_0 handler: a line buffer has gone to the PIO
+static void __not_in_flash_func(vga_line_irq)(void) {
+    for (int b = 0; b < 2; b++) {
+        uint32_t mask = 1u << line_chan[b] ;
+        if (!(dma_hw->ints0 & mask)) continue ;
+        dma_hw->ints0 = mask ;
+        vga_scan_line = line_of[b] + 1 < VGA_HEIGHT ? line_of[b] + 1 : 0 ;
+        line_of[b] = line_of[b] + 2 < VGA_HEIGHT ? line_of[b] + 2 : line_of[b] + 2 - VGA_HEIGHT ;
+        compose_line(b, line_of[b]) ;
+        // Re-arm without triggering; the other channel chains to this one
+        dma_channel_set_read_addr(line_chan[b], line_buffers[b], false) ;
+    }
+}
+
+void vga_line_stats(VgaLineStats *stats) {
+    *stats = line_stats ;
+}
+
+void vga_line_stats_reset() {
+    uint32_t budget = line_stats.budget ;
+    memset(&line_stats, 0, sizeof(line_stats)) ;
+    line_stats.budget = budget ;
+}
+#endif
 
 void initVGA() {
         // Choose which PIO instance to use (there are two instances, each with 4 state machines)
@@ -66,7 +305,11 @@ void initVGA() {
     // and is of the form <program name_program>
     uint hsync_offset = pio_add_program(pio, &hsync_program);
     uint vsync_offset = pio_add_program(pio, &vsync_program);
+#if VGA_LOWRES
+    uint rgb_offset = pio_add_program(pio, &rgb_lowres_program);
+#else
     uint rgb_offset = pio_add_program(pio, &rgb_program);
+#endif
 
     // Manually select a few state machines from pio instance pio0.
     uint hsync_sm = 0;
@@ -79,13 +322,86 @@ void initVGA() {
     // is consolidated in one place. Here in the C, we then just import and use it.
     hsync_program_init(pio, hsync_sm, hsync_offset, HSYNC);
     vsync_program_init(pio, vsync_sm, vsync_offset, VSYNC);
+#if VGA_LOWRES
+    rgb_lowres_program_init(pio, rgb_sm, rgb_offset, LO_GRN);
+#else
     rgb_program_init(pio, rgb_sm, rgb_offset, LO_GRN);
+#endif
 
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
     // ============================== PIO DMA Channels =================================================
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#if VGA_LINE_COMPOSE
+    // DMA channels - two line buffers, chained to each other
+    for (int b = 0; b < 2; b++) {
+        line_chan[b] = dma_claim_unused_channel(true) ;
+    }
+    for (int b = 0; b < 2; b++) {
+        dma_channel_config c = dma_channel_get_default_config(line_chan[b]) ;
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_8) ;
+        channel_config_set_read_increment(&c, true) ;
+        channel_config_set_write_increment(&c, false) ;
+        channel_config_set_dreq(&c, DREQ_PIO0_TX2) ;
+        channel_config_set_chain_to(&c, line_chan[b ^ 1]) ;
+        dma_channel_configure(line_chan[b], &c, &pio->txf[rgb_sm], line_buffers[b], VGA_STRIDE, false) ;
+        dma_channel_set_irq0_enabled(line_chan[b], true) ;
+    }
+
+    // Cycle counter for the line budget, and the first two lines
+    systick_hw->rvr = 0x00ffffff ;
+    systick_hw->csr = 0x5 ;             // enabled, counting processor clocks
+    line_stats.budget = clock_get_hz(clk_sys) / 31469 ;     // 31.469 kHz line rate
+    for (int b = 0; b < 2; b++) {
+        line_of[b] = b ;
+        compose_line(b, b) ;
+    }
+    irq_set_exclusive_handler(DMA_IRQ_0, vga_line_irq) ;
+    irq_set_enabled(DMA_IRQ_0, true) ;
+#elif VGA_LOWRES
+    // DMA channels - 0 sends one line, 1 loads the next line's control block
+    // into 0 and triggers it
+    int rgb_chan_0 = dma_claim_unused_channel(true);
+    int rgb_chan_1 = dma_claim_unused_channel(true);
+
+    for (int i = 0; i < V_LINES + 2; i++) {
+        line_table[i] = &vga_data_array[(i % V_LINES) / 2 * VGA_STRIDE] ;
+    }
+
+    // Channel Zero (sends one line of color data to PIO VGA machine)
+    dma_channel_config c0 = dma_channel_get_default_config(rgb_chan_0);  // default configs
+    channel_config_set_transfer_data_size(&c0, DMA_SIZE_8);              // 8-bit txfers
+    channel_config_set_read_increment(&c0, true);                        // yes read incrementing
+    channel_config_set_write_increment(&c0, false);                      // no write incrementing
+    channel_config_set_dreq(&c0, DREQ_PIO0_TX2) ;                        // DREQ_PIO0_TX2 pacing (FIFO)
+    channel_config_set_chain_to(&c0, rgb_chan_1);                        // chain to other channel
+
+    dma_channel_configure(
+        rgb_chan_0,                 // Channel to be configured
+        &c0,                        // The configuration we just created
+        &pio->txf[rgb_sm],          // write address (RGB PIO TX FIFO)
+        line_table[0],              // The initial read address (set by channel 1)
+        VGA_STRIDE,                 // One line; reloaded on each trigger
+        false                       // Don't start immediately.
+    );
+
+    // Channel One (walks the control blocks, rewound in the vblank IRQ)
+    dma_channel_config c1 = dma_channel_get_default_config(rgb_chan_1);   // default configs
+    channel_config_set_transfer_data_size(&c1, DMA_SIZE_32);              // 32-bit txfers
+    channel_config_set_read_increment(&c1, true);                         // next block each time
+    channel_config_set_write_increment(&c1, false);                       // no write incrementing
+
+    dma_channel_configure(
+        rgb_chan_1,                                 // Channel to be configured
+        &c1,                                        // The configuration we just created
+        &dma_hw->ch[rgb_chan_0].al3_read_addr_trig, // Write address (channel 0 read address, triggering)
+        line_table,                                 // Read address (the control blocks)
+        1,                                          // One block per line
+        false                                       // Don't start immediately.
+    );
+    vga_control_chan = rgb_chan_1 ;
+#else
     // DMA channels - 0 sends color data, 1 reconfigures and restarts 0
     int rgb_chan_0 = dma_claim_unused_channel(true);
     int rgb_chan_1 = dma_claim_unused_channel(true);
@@ -122,6 +438,7 @@ void initVGA() {
         1,                                  // Number of transfers, in this case each is 4 byte
         false                               // Don't start immediately.
     );
+#endif
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
     /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -133,6 +450,10 @@ void initVGA() {
     pio_sm_put_blocking(pio, vsync_sm, V_ACTIVE);
     pio_sm_put_blocking(pio, rgb_sm, RGB_ACTIVE);
 
+    // Frame clock: route the vsync program's IRQ 2 to this core
+    pio_set_irq0_source_enabled(pio, pis_interrupt2, true) ;
+    irq_set_exclusive_handler(PIO0_IRQ_0, vga_vblank_irq) ;
+    irq_set_enabled(PIO0_IRQ_0, true) ;
 
     // Start the two pio machine IN SYNC
     // Note that the RGB state machine is running at full speed,
@@ -144,7 +465,100 @@ void initVGA() {
     // will be continously DMA's to the PIO machines that are driving the screen.
     // To change the contents of the screen, we need only change the contents
     // of that array.
+#if VGA_LINE_COMPOSE
+    dma_start_channel_mask((1u << line_chan[0])) ;
+#elif VGA_LOWRES
+    dma_start_channel_mask((1u << rgb_chan_1)) ;
+    vga_pixel_chan = rgb_chan_0 ;
+#else
     dma_start_channel_mask((1u << rgb_chan_0)) ;
+    vga_pixel_chan = rgb_chan_0 ;
+#endif
+}
+
+int vga_get_scanline() {
+#if VGA_LINE_COMPOSE
+    int line = vga_scan_line ;
+#elif VGA_LOWRES
+    // Channel 1 has loaded the block of the line channel 0 is sending
+    const unsigned char **next = (const unsigned char **)dma_hw->ch[vga_control_chan].read_addr ;
+    int line = (int)(next - line_table - 1) % V_LINES / 2 ;
+#else
+    // Channel 0 runs at most a FIFO's worth ahead of the pixels on screen
+    uint32_t sent = TXCOUNT - dma_hw->ch[vga_pixel_chan].transfer_count ;
+    int line = sent / VGA_STRIDE ;
+#endif
+    // Between frames channel 0 is already reloaded and stalled on the full
+    // FIFO, which reads as line 0. IRQ 2 goes up before that reload, so
+    // while it is pending vga_vblank_us is still a frame old and the flag
+    // itself says blanking; once handled, the frame clock tells the two apart
+    if (line == 0 && (pio_interrupt_get(pio0, 2) ||
+                      time_us_32() - vga_vblank_us < VGA_VBLANK_US)) {
+        return VGA_HEIGHT ;
+    }
+    return line ;
+}
+#else
+void initVGA() {
+}
+
+int vga_get_scanline() {
+    return VGA_HEIGHT ;
+}
+#endif
+
+// Whether lines [y0, y1) can be written without the beam catching up
+static bool vga_region_clear(short y0, short y1) {
+    int line = vga_get_scanline() ;
+    return line >= y1 || line + VGA_DRAW_LEAD < y0 ;
+}
+
+void vga_draw_flush() {
+    // Lines covered by draws left queued: a later draw overlapping them
+    // waits too, so overlapping draws land in order
+    short held_y0 = VGA_HEIGHT, held_y1 = 0 ;
+    int kept = 0 ;
+    for (int i = 0; i < draw_count; i++) {
+        VgaDraw d = draw_queue[i] ;
+        if (!(d.ordered && kept) && (d.y0 >= held_y1 || d.y1 <= held_y0) &&
+            vga_region_clear(d.y0, d.y1)) {
+            d.fn(d.arg, d.data) ;
+        } else {
+            draw_queue[kept++] = d ;
+            if (d.y0 < held_y0) held_y0 = d.y0 ;
+            if (d.y1 > held_y1) held_y1 = d.y1 ;
+        }
+    }
+    draw_count = kept ;
+}
+
+static void draw_enqueue(short y, short h, VgaDrawFn fn, void *arg, int data, bool ordered) {
+    if (draw_count == VGA_DRAW_QUEUE) {
+        // Tearing beats losing draws
+        for (int i = 0; i < draw_count; i++) {
+            draw_queue[i].fn(draw_queue[i].arg, draw_queue[i].data) ;
+        }
+        draw_count = 0 ;
+    }
+    VgaDraw *d = &draw_queue[draw_count++] ;
+    d->y0 = y < 0 ? 0 : y ;
+    d->y1 = y + h > VGA_HEIGHT ? VGA_HEIGHT : y + h ;
+    d->fn = fn ;
+    d->arg = arg ;
+    d->data = data ;
+    d->ordered = ordered ;
+}
+
+void vga_draw_defer(short y, short h, VgaDrawFn fn, void *arg, int data) {
+    draw_enqueue(y, h, fn, arg, data, false) ;
+}
+
+void vga_draw_defer_ordered(short y, short h, VgaDrawFn fn, void *arg, int data) {
+    draw_enqueue(y, h, fn, arg, data, true) ;
+}
+
+bool vga_draw_pending() {
+    return draw_count > 0 ;
 }
 
 
@@ -153,36 +567,62 @@ void initVGA() {
 // a DMA channel, we only need to modify the contents of the array and the
 // pixels will be automatically updated on the screen.
 void drawPixel(short x, short y, char color) {
+    DrawTarget *t = draw_target() ;
+    x -= t->x0 ;
+    y -= t->y0 ;
+    if (t->base != vga_data_array) {
+        // Off-screen buffers clip, so a render can overhang its buffer
+        if((x >= t->w) | (x < 0) | (y >= t->h) | (y < 0) ) return;
+    }
     // Range checks (640x480 display)
-    if (x > 639) x = 639 ;
+    if (x > t->w-1) x = t->w-1 ;
     if (x < 0) x = 0 ;
     if (y < 0) y = 0 ;
-    if (y > 479) y = 479 ;
+    if (y > t->h-1) y = t->h-1 ;
     //if((x > 639) | (x < 0) | (y > 479) | (y < 0) ) return;
 
     // Which pixel is it?
-    int pixel = ((640 * y) + x) ;
+    int pixel = ((t->w * y) + x) ;
 
     // Is this pixel stored in the first 4 bits
     // of the vga data array index, or the second
     // 4 bits? Check, then mask.
     if (pixel & 1) {
-        vga_data_array[pixel>>1] = (vga_data_array[pixel>>1] & TOPMASK) | (color << 4) ;
+        t->base[pixel>>1] = (t->base[pixel>>1] & TOPMASK) | (color << 4) ;
     }
     else {
-        vga_data_array[pixel>>1] = (vga_data_array[pixel>>1] & BOTTOMMASK) | (color) ;
+        t->base[pixel>>1] = (t->base[pixel>>1] & BOTTOMMASK) | (color) ;
     }
 }
 
 void drawVLine(short x, short y, short h, char color) {
-    for (short i=y; i<(y+h); i++) {
-        drawPixel(x, i, color) ;
+    if (h <= 0) return ;
+    DrawTarget *t = draw_target() ;
+    // Lines that leave the screen keep the clamping behaviour of drawPixel
+    if (!on_screen(t, x, y, 1, h)) {
+        for (short i=y; i<(y+h); i++) {
+            drawPixel(x, i, color) ;
+        }
+        return ;
+    }
+    fb_span_begin(t, fb_index(t, x, y), t->w) ;
+    for (short i=0; i<h; i++) {
+        fb_span_put(color) ;
     }
 }
 
 void drawHLine(short x, short y, short w, char color) {
-    for (short i=x; i<(x+w); i++) {
-        drawPixel(i, y, color) ;
+    if (w <= 0) return ;
+    DrawTarget *t = draw_target() ;
+    if (!on_screen(t, x, y, w, 1)) {
+        for (short i=x; i<(x+w); i++) {
+            drawPixel(i, y, color) ;
+        }
+        return ;
+    }
+    fb_span_begin(t, fb_index(t, x, y), 1) ;
+    for (short i=0; i<w; i++) {
+        fb_span_put(color) ;
     }
 }
 
@@ -224,6 +664,26 @@ void drawLine(short x0, short y0, short x1, short y1, char color) {
         ystep = -1;
       }
 
+      // Fully visible lines step through the framebuffer with the span
+      // kernel: the major axis is the stride, the minor axis an extra shift
+      DrawTarget *t = draw_target() ;
+      short lo = (y0 < y1) ? y0 : y1 ;
+      if ( steep ? on_screen(t, lo, x0, abs(y1 - y0) + 1, dx + 1)
+                 : on_screen(t, x0, lo, dx + 1, abs(y1 - y0) + 1) ) {
+        int major = steep ? t->w : 1 ;
+        int minor = steep ? ystep : ystep * t->w ;
+        fb_span_begin(t, steep ? fb_index(t, y0, x0) : fb_index(t, x0, y0), major) ;
+        for (; x0<=x1; x0++) {
+          fb_span_put(color) ;
+          err -= dy;
+          if (err < 0) {
+            fb_span_shift(minor) ;
+            err += dx;
+          }
+        }
+        return ;
+      }
+
       for (; x0<=x1; x0++) {
         if (steep) {
           drawPixel(y0, x0, color);
@@ -441,9 +901,33 @@ void fillRect(short x, short y, short w, short h, char color) {
 
   // tft_setAddrWindow(x, y, x+w-1, y+h-1);
 
-  for(int i=x; i<(x+w); i++) {
-    for(int j=y; j<(y+h); j++) {
-        drawPixel(i, j, color);
+  if (w <= 0 || h <= 0) return;
+  DrawTarget *t = draw_target();
+  if (!on_screen(t, x, y, w, h)) {
+    for(int i=x; i<(x+w); i++) {
+      for(int j=y; j<(y+h); j++) {
+          drawPixel(i, j, color);
+      }
+    }
+    return;
+  }
+
+  // Row spans: odd leading/trailing pixels through the span kernel,
+  // whole bytes (pixel pairs) with memset
+  unsigned char pair = (color << 4) | (color & TOPMASK);
+  for(int j=y; j<(y+h); j++) {
+    int first = fb_index(t, x, j);
+    int last = first + w;         // one past the end
+    if (first & 1) {
+      fb_span_begin(t, first++, 1);
+      fb_span_put(color);
+    }
+    if (last > first && (last & 1)) {
+      fb_span_begin(t, --last, 1);
+      fb_span_put(color);
+    }
+    if (last > first) {
+      memset(&t->base[first >> 1], pair, (last - first) >> 1);
     }
   }
 }
@@ -451,12 +935,29 @@ void fillRect(short x, short y, short w, short h, char color) {
 // Draw a character
 void drawChar(short x, short y, unsigned char c, char color, char bg, unsigned char size) {
     char i, j;
-  if((x >= _width)            || // Clip right
-     (y >= _height)           || // Clip bottom
-     ((x + 6 * size - 1) < 0) || // Clip left
-     ((y + 8 * size - 1) < 0))   // Clip top
+  DrawTarget *t = draw_target();
+  if((x >= t->x0 + t->w)           || // Clip right
+     (y >= t->y0 + t->h)           || // Clip bottom
+     ((x + 6 * size - 1) < t->x0)  || // Clip left
+     ((y + 8 * size - 1) < t->y0))    // Clip top
     return;
 
+  // Unscaled glyphs that fit on screen are written one 8-pixel column at a
+  // time through the span kernel
+  if (size == 1 && on_screen(t, x, y, 6, 8)) {
+    for (i=0; i<6; i++ ) {
+      unsigned char line = (i == 5) ? 0x0 : pgm_read_byte(font+(c*5)+i);
+      fb_span_begin(t, fb_index(t, x + i, y), t->w);
+      for ( j = 0; j<8; j++) {
+        if (line & 0x1)       fb_span_put(color);
+        else if (bg != color) fb_span_put(bg);
+        else                  fb_span_skip();
+        line >>= 1;
+      }
+    }
+    return;
+  }
+
   for (i=0; i<6; i++ ) {
     unsigned char line;
     if (i == 5)
@@ -525,22 +1026,24 @@ inline void setTextWrap(char w) {
 
 
 void tft_write(unsigned char c){
+  // cursor_x is in screen coordinates; the target's columns start at x0
+  DrawTarget *t = draw_target();
   if (c == '\n') {
     cursor_y += textsize*8;
-    cursor_x  = 0;
+    cursor_x  = t->x0;
   } else if (c == '\r') {
     // skip em
   } else if (c == '\t'){
       int new_x = cursor_x + tabspace;
-      if (new_x < _width){
+      if (new_x - t->x0 < t->w){
           cursor_x = new_x;
       }
   } else {
     drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
     cursor_x += textsize*6;
-    if (wrap && (cursor_x > (_width - textsize*6))) {
+    if (wrap && (cursor_x - t->x0 > (t->w - textsize*6))) {
       cursor_y += textsize*8;
-      cursor_x = 0;
+      cursor_x = t->x0;
     }
   }
 }
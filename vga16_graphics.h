@@ -15,7 +15,7 @@
  * RESOURCES USED
  *  - PIO state machines 0, 1, and 2 on PIO instance 0
  *  - DMA channels 0, 1, 2, and 3
- *  - 153.6 kBytes of RAM (for pixel color data)
+ *  - 153.6 kBytes of RAM (for pixel color data), 38.4 kBytes at 320x240
  *
  * NOTE
  *  - This is a translation of the display primitives
@@ -24,6 +24,27 @@
  */
 
 
+#ifndef VGA16_GRAPHICS_H
+#define VGA16_GRAPHICS_H
+
+// Screen geometry (4 bits per pixel, two pixels per byte). Low resolution
+// mode (build with VGA_LOWRES=1) is 320x240, each pixel shown as 2x2 on the
+// same 640x480 signal, with a quarter of the framebuffer.
+#ifndef VGA_LOWRES
+#define VGA_LOWRES 0
+#endif
+#if VGA_LOWRES
+#define VGA_WIDTH  320
+#define VGA_HEIGHT 240
+#else
+#define VGA_WIDTH  640
+#define VGA_HEIGHT 480
+#endif
+#define VGA_STRIDE (VGA_WIDTH / 2)
+
+// The framebuffer itself, VGA_STRIDE bytes per line, even x in the low nibble
+extern unsigned char vga_data_array[] ;
+
 // Give the I/O pins that we're using some names that make sense - usable in main()
  enum vga_pins {HSYNC=16, VSYNC, LO_GRN, HI_GRN, BLUE_PIN, RED_PIN} ;
 
@@ -33,6 +54,95 @@ enum colors {BLACK, DARK_GREEN, MED_GREEN, GREEN,
             RED, DARK_ORANGE, ORANGE, YELLOW, 
             MAGENTA, PINK, LIGHT_PINK, WHITE} ;
 
+// Frame clock: counts vertical blanks (60 Hz), raised by the vsync PIO
+// program as the last active line starts. vga_vblank_us is time_us_32()
+// at the latest one.
+extern volatile uint32_t vga_frame_count ;
+extern volatile uint32_t vga_vblank_us ;
+#define VGA_FRAME_US 16683 // 525 lines of 31.78 us
+
+// Inside a protothread: yield until vga_frame_count reaches frame.
+// The thread is woken just before the expected vblank and polls from there.
+#define PT_WAIT_FRAME(pt, frame) do { \
+    static uint32_t vga_wait_target ; \
+    vga_wait_target = (frame) ; \
+    PT_SET_WAKE(time_us_64() + vga_frames_until(vga_wait_target)) ; \
+    PT_YIELD_UNTIL(pt, (int32_t)(vga_frame_count - vga_wait_target) >= 0) ; \
+} while (0)
+// Yield until the next vertical blank starts
+#define PT_WAIT_VBLANK(pt) PT_WAIT_FRAME(pt, vga_frame_count + 1)
+
+// Microseconds until shortly before vga_frame_count reaches frame
+static inline uint32_t vga_frames_until(uint32_t frame) {
+    int32_t frames = (int32_t)(frame - vga_frame_count) ;
+    int32_t us = frames * VGA_FRAME_US - (int32_t)(time_us_32() - vga_vblank_us) - 500 ;
+    return us > 0 ? us : 0 ;
+}
+
+// Beam position: the framebuffer line being scanned out (0 .. VGA_HEIGHT-1), or
+// VGA_HEIGHT during vertical blank. Always VGA_HEIGHT in the host build.
+#define VGA_VBLANK_US 1430 // 45 lines of blanking
+int vga_get_scanline(void) ;
+
+// Line compositing mode (build with VGA_LINE_COMPOSE=1): the framebuffer
+// is no longer sent straight to the PIO. Each line is copied into one of
+// two line buffers from a DMA interrupt, one line ahead of the beam, and
+// the hook can draw over it (e.g. sprites) without touching
+// vga_data_array. The hook returns how many sprites it drew on the line.
+#ifndef VGA_LINE_COMPOSE
+#define VGA_LINE_COMPOSE 0
+#endif
+#if VGA_LINE_COMPOSE && VGA_LOWRES
+#error "VGA_LINE_COMPOSE works at full resolution only"
+#endif
+typedef int (*VgaLineHook)(unsigned char *line, int y) ;
+
+// Time spent preparing each line, in CPU cycles, against the budget of
+// one line period. Lines with sprites are counted apart from those
+// without, to give the cost of the copy and of each sprite.
+typedef struct {
+    uint32_t budget ;           // cycles in one line period
+    uint32_t lines ;            // lines prepared
+    uint32_t late ;             // lines over budget
+    uint32_t max_cycles ;
+    uint64_t base_cycles ;      // spent on lines without sprites
+    uint32_t sprite_lines ;     // lines with sprites
+    uint64_t sprite_cycles ;    // spent on them
+    uint32_t sprites ;          // sprites drawn on them
+    uint32_t max_sprites ;      // most on one line
+} VgaLineStats ;
+
+#if VGA_LINE_COMPOSE
+// Set the hook before initVGA(); it runs in the interrupt, from RAM
+void vga_set_line_hook(VgaLineHook hook) ;
+void vga_line_stats(VgaLineStats *stats) ;
+void vga_line_stats_reset(void) ;
+#endif
+
+// Draws deferred until the beam is clear of them. There is no back buffer,
+// so a write just ahead of the scanout tears; a queued draw covering lines
+// [y, y+h) runs from vga_draw_flush() once the beam has passed those lines,
+// or is far enough above them to stay clear while fn runs. fn must not
+// queue draws itself. If the queue is full, everything queued is drawn at
+// once.
+#ifndef VGA_DRAW_QUEUE
+#define VGA_DRAW_QUEUE 64 // queued draws
+#endif
+#define VGA_DRAW_LEAD 16 // lines the beam must stay above a region (~0.5 ms)
+typedef void (*VgaDrawFn)(void *arg, int data) ;
+void vga_draw_defer(short y, short h, VgaDrawFn fn, void *arg, int data) ;
+// Like vga_draw_defer, but also waits for every draw queued before it,
+// whatever lines they cover (e.g. a sprite show behind its hide)
+void vga_draw_defer_ordered(short y, short h, VgaDrawFn fn, void *arg, int data) ;
+void vga_draw_flush(void) ;
+bool vga_draw_pending(void) ;
+
+// Point this core's drawing primitives at an off-screen buffer of w x h
+// pixels (w even, w / 2 bytes per row) that stands in for the screen
+// rectangle at (x, y): primitives keep taking screen coordinates, and clip
+// to the buffer. NULL puts them back on the screen.
+void vga_set_target(unsigned char *pixels, short w, short h, short x, short y) ;
+
 // VGA primitives - usable in main
 void initVGA(void) ;
 void drawPixel(short x, short y, char color) ;
@@ -61,4 +171,6 @@ void writeStringBig(char* str) ;
 void setTextColorBig(char, char); //works, but can use usual setTextColor2
 // 5x7 font
 void writeStringBold(char* str);
-void drawOval(short x0, short y0, short rx, short ry, char color);
\ No newline at end of file
+void drawOval(short x0, short y0, short rx, short ry, char color);
+
+#endif // VGA16_GRAPHICS_H